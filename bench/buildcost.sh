@@ -0,0 +1,185 @@
+#!/usr/bin/env bash
+# This file is part of qAccordion. An Accordion widget for Qt
+# Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Build cost benchmark. Compares
+#
+#  * the compile time and preprocessed size of a translation unit that only
+#    includes qaccordion/qaccordion.hpp, and the build time of the library,
+#    before and after the public headers moved their state behind a pimpl
+#  * the build time, binary size, dynamic relocations and process startup of
+#    accordion_bench_startup for a shared, a static and a static LTO build
+#
+# The results are printed as markdown tables. Needs git, cmake, a C++ compiler
+# and Qt 5. Startup relocation statistics need glibc (LD_DEBUG).
+#
+# Usage: bench/buildcost.sh [-r runs] [-j jobs] [before revision]
+#
+# The before revision defaults to the parent of the commit that added
+# src/qaccordion_p.hpp. The after tree is the working tree of this checkout.
+
+set -e
+
+RUNS=10
+JOBS=$(nproc 2>/dev/null || echo 2)
+while getopts "r:j:" opt; do
+    case $opt in
+        r) RUNS=$OPTARG ;;
+        j) JOBS=$OPTARG ;;
+        *) echo "Usage: $0 [-r runs] [-j jobs] [before revision]" >&2
+           exit 1 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+SOURCE_DIR=$(cd "$(dirname "$0")/.." && pwd)
+BEFORE=$1
+if [ -z "$BEFORE" ]; then
+    BEFORE=$(git -C "$SOURCE_DIR" log --diff-filter=A --format=%H \
+        -- src/qaccordion_p.hpp | tail -n 1)^
+fi
+BEFORE=$(git -C "$SOURCE_DIR" rev-parse --short "$BEFORE")
+
+WORK_DIR=$(mktemp -d)
+cleanup()
+{
+    git -C "$SOURCE_DIR" worktree remove --force "$WORK_DIR/before" \
+        >/dev/null 2>&1 || true
+    rm -rf "$WORK_DIR"
+}
+trap cleanup EXIT
+
+# milliseconds since the epoch
+now()
+{
+    echo $(($(date +%s%N) / 1000000))
+}
+
+# run a command quietly and print how many milliseconds it took
+elapsed()
+{
+    local start
+    start=$(now)
+    "$@" >"$WORK_DIR/last.log" 2>&1 || {
+        cat "$WORK_DIR/last.log" >&2
+        exit 1
+    }
+    echo $(($(now) - start))
+}
+
+# configure the tree $1 into the build directory $2 with the remaining options
+configure()
+{
+    local tree=$1 build=$2
+    shift 2
+    elapsed cmake -S "$tree" -B "$build" -DCMAKE_BUILD_TYPE=Release \
+        -DCMAKE_EXPORT_COMPILE_COMMANDS=ON "$@"
+}
+
+# time a clean single threaded build of target $2 in build directory $1
+clean_build()
+{
+    cmake --build "$1" --target clean >/dev/null
+    elapsed cmake --build "$1" --target "$2" -- -j1
+}
+
+# print the compile command cmake uses for src/qaccordion.cpp with the source
+# file replaced by $2 and the object file by $3
+header_command()
+{
+    grep '"command":.*/src/qaccordion\.cpp"' "$1/compile_commands.json" |
+        sed -e 's/^ *"command": "//' -e 's/",\{0,1\}$//' -e 's/\\"/"/g' \
+            -e "s# -o [^ ]*# -o $3#" -e "s# -c [^ ]*# -c $2#"
+}
+
+# average compile time in milliseconds of the header only translation unit
+header_time()
+{
+    local command total=0
+    command=$(header_command "$1" "$WORK_DIR/header.cpp" /dev/null)
+    for ((i = 0; i < RUNS; i++)); do
+        total=$((total + $(cd "$1" && elapsed eval "$command")))
+    done
+    echo $((total / RUNS))
+}
+
+# lines of the preprocessed header only translation unit
+header_lines()
+{
+    local command
+    command=$(header_command "$1" "$WORK_DIR/header.cpp" "$WORK_DIR/header.i")
+    (cd "$1" && eval "${command/ -c / -E }") >/dev/null
+    wc -l <"$WORK_DIR/header.i"
+}
+
+# the benchmarks do not show a window, do not depend on a display
+export QT_QPA_PLATFORM=offscreen
+echo '#include "qaccordion/qaccordion.hpp"' >"$WORK_DIR/header.cpp"
+git -C "$SOURCE_DIR" worktree add --detach "$WORK_DIR/before" "$BEFORE" \
+    >/dev/null 2>&1
+
+echo "Runs per measurement: $RUNS, compiler: $(c++ --version | head -n 1)"
+echo
+echo "| tree | qaccordion.hpp TU (ms) | preprocessed lines |" \
+    "library build -j1 (ms) |"
+echo "|---|---|---|---|"
+for tree in before after; do
+    if [ $tree = before ]; then
+        dir=$WORK_DIR/before
+        name="before ($BEFORE)"
+    else
+        dir=$SOURCE_DIR
+        name="after (working tree)"
+    fi
+    build=$WORK_DIR/header-$tree
+    configure "$dir" "$build" >/dev/null
+    # the autogen and config headers have to exist before the TU compiles
+    library=$(clean_build "$build" qaccordion)
+    echo "| $name | $(header_time "$build") | $(header_lines "$build") |" \
+        "$library |"
+done
+
+echo
+echo "| build | configure (ms) | build -j$JOBS (ms) | binary (bytes) |" \
+    "library (bytes) | relocations | startup (ms) |"
+echo "|---|---|---|---|---|---|---|"
+for variant in shared static lto; do
+    case $variant in
+        shared) options=() ;;
+        static) options=(-DQACCORDION_STATIC=ON) ;;
+        lto) options=(-DQACCORDION_STATIC=ON -DQACCORDION_LTO=ON) ;;
+    esac
+    build=$WORK_DIR/startup-$variant
+    configured=$(configure "$SOURCE_DIR" "$build" \
+        -DQACCORDION_BUILD_BENCHMARK=ON "${options[@]}")
+    built=$(elapsed cmake --build "$build" --target accordion_bench_startup \
+        -- -j"$JOBS")
+    binary=$build/src/accordion_bench_startup
+    library=0
+    if [ $variant = shared ]; then
+        library=$(stat -L -c %s "$build"/src/libqaccordion.so)
+    fi
+    # warm the page cache, the first run is not counted
+    "$binary" >/dev/null 2>&1
+    relocations=$(LD_DEBUG=statistics "$binary" 2>&1 |
+        sed -n 's/.*number of relocations: *\([0-9]*\).*/\1/p' | head -n 1)
+    total=0
+    for ((i = 0; i < RUNS; i++)); do
+        total=$((total + $(elapsed "$binary")))
+    done
+    echo "| $variant | $configured | $built | $(stat -c %s "$binary") |" \
+        "$library | ${relocations:-n/a} | $((total / RUNS)) |"
+done
@@ -0,0 +1,130 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * Memory benchmark. Fills an accordion with 1k, 10k and 100k content panes
+ * and prints the estimated bytes per pane, broken down by component, next to
+ * the growth of the resident set size. The resident set size is read from
+ * /proc and only reported on Linux.
+ *
+ * Usage: accordion_bench_memory [number of panes ...]
+ */
+
+#include <QApplication>
+#include <QFile>
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+#include "qaccordion/qaccordion.hpp"
+
+// resident set size in bytes, 0 if unknown
+static qint64 residentSetSize()
+{
+#ifdef Q_OS_LINUX
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    QList<QByteArray> fields = statm.readAll().split(' ');
+    if (fields.size() < 2) {
+        return 0;
+    }
+    // the values are in pages
+    return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+#else
+    return 0;
+#endif
+}
+
+static double perPane(std::size_t bytes, int panes)
+{
+    return static_cast<double>(bytes) / static_cast<double>(panes);
+}
+
+static void runBenchmark(int panes)
+{
+    std::vector<PaneSpec> specs;
+    specs.reserve(static_cast<std::size_t>(panes));
+    for (int i = 0; i < panes; i++) {
+        QString header = "Content Pane " + QString::number(i);
+        specs.push_back({header, header, nullptr});
+    }
+
+    qint64 rssBefore = residentSetSize();
+    auto accordion = std::make_unique<QAccordion>();
+    // setPanes() is O(n), adding one by one checks every header
+    accordion->setPanes(specs);
+    qint64 rssAfter = residentSetSize();
+
+    // n/a if the resident set size can not be read on this platform
+    QByteArray rss("n/a");
+    if (rssBefore > 0 && rssAfter > 0) {
+        rss = QByteArray::number(
+            perPane(static_cast<std::size_t>(
+                        std::max<qint64>(0, rssAfter - rssBefore)),
+                    panes),
+            'f', 1);
+    }
+
+    MemoryFootprint footprint = accordion->getMemoryFootprint();
+    std::printf("%8d %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f "
+                "%10.1f %10s\n",
+                panes, perPane(footprint.widgets, panes),
+                perPane(footprint.layouts, panes),
+                perPane(footprint.animations, panes),
+                perPane(footprint.pixmaps, panes),
+                perPane(footprint.strings, panes),
+                perPane(footprint.content, panes),
+                perPane(footprint.other, panes),
+                perPane(footprint.total(), panes), rss.constData());
+    std::fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+    // no window is shown, do not depend on a display
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; i++) {
+        int panes = QString(argv[i]).toInt();
+        if (panes > 0) {
+            sizes.push_back(panes);
+        }
+    }
+    if (sizes.empty()) {
+        sizes = {1000, 10000, 100000};
+    }
+
+    std::printf("Estimated bytes per content pane\n");
+    std::printf("%8s %10s %10s %10s %10s %10s %10s %10s %10s %10s\n", "panes",
+                "widgets", "layouts", "animations", "pixmaps", "strings",
+                "content", "other", "total", "rss");
+    for (int panes : sizes) {
+        runBenchmark(panes);
+    }
+    return 0;
+}
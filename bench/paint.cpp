@@ -0,0 +1,283 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+ * Paint benchmark. Builds accordions of different sizes, open ratios and
+ * header styles inside a scroll area on the offscreen platform and renders
+ * the viewport with QWidget::render() into a QImage. The accordion and its
+ * panes fill their background, every configuration runs with and without
+ * BackgroundCache.
+ *
+ * - full:      the whole viewport is rendered
+ * - scrolled:  the viewport scrolls by 10 pixels and only the strip that
+ *              scrolled in is rendered
+ * - animation: the first visible pane opens, every frame the animation is
+ *              stepped by 16 ms with an AnimationClock, the layout is updated
+ *              and the viewport is rendered
+ *
+ * Reported are milliseconds per frame and microseconds per visible pane.
+ *
+ * Usage: accordion_bench_paint [frames] [number of panes ...]
+ */
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QLinearGradient>
+#include <QScrollArea>
+#include <QScrollBar>
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "qaccordion/animationclock.hpp"
+#include "qaccordion/backgroundcache.hpp"
+#include "qaccordion/qaccordion.hpp"
+
+enum class HEADER_STYLE { DEFAULT, SHARED, PER_PANE };
+
+static const char *const HEADER_STYLESHEET =
+    "background-color: qlineargradient(x1: 0, y1: 0, x2: 0, y2: 1, "
+    "stop: 0 #f6f7fa, stop: 1 #dadbde); color: #202020;";
+static const char *const HEADER_HOVER_STYLESHEET =
+    "background-color: #e0e4f0;";
+
+// the same look as the style sheets above
+static HeaderStyle sharedHeaderStyle()
+{
+    QLinearGradient gradient(0, 0, 0, 1);
+    gradient.setCoordinateMode(QGradient::ObjectBoundingMode);
+    gradient.setColorAt(0, QColor("#f6f7fa"));
+    gradient.setColorAt(1, QColor("#dadbde"));
+
+    HeaderStyle style;
+    style.background = QBrush(gradient);
+    style.hoverBackground = QColor("#e0e4f0");
+    style.textColor = QColor("#202020");
+    return style;
+}
+
+static const char *styleName(HEADER_STYLE style)
+{
+    switch (style) {
+    case HEADER_STYLE::SHARED:
+        return "shared";
+    case HEADER_STYLE::PER_PANE:
+        return "per-pane";
+    default:
+        return "default";
+    }
+}
+
+class PaintBenchmark
+{
+public:
+    PaintBenchmark(int panes, double openRatio, HEADER_STYLE style,
+                   bool cache)
+        : panes(panes), openRatio(openRatio), style(style), cache(cache)
+    {
+        this->clock.install();
+        BackgroundCache::setEnabled(cache);
+
+        this->scrollArea.resize(400, 600);
+        this->scrollArea.setWidgetResizable(true);
+        this->accordion = new QAccordion();
+        this->accordion->setMultiActive(true);
+        // the cache only handles filled or styled backgrounds
+        this->accordion->setAutoFillBackground(true);
+
+        std::vector<PaneSpec> specs;
+        specs.reserve(static_cast<std::size_t>(panes));
+        for (int i = 0; i < panes; i++) {
+            QString header = "Content Pane " + QString::number(i);
+            specs.push_back({header, header, nullptr});
+        }
+        this->accordion->setPanes(specs);
+        for (int i = 0; i < panes; i++) {
+            this->accordion->getContentPane(static_cast<uint>(i))
+                ->setAutoFillBackground(true);
+        }
+
+        if (style == HEADER_STYLE::SHARED) {
+            this->accordion->setHeaderStyle(sharedHeaderStyle());
+        } else if (style == HEADER_STYLE::PER_PANE) {
+            for (int i = 0; i < panes; i++) {
+                ContentPane *cpane =
+                    this->accordion->getContentPane(static_cast<uint>(i));
+                cpane->setHeaderStylesheet(HEADER_STYLESHEET);
+                cpane->setHeaderHoverStylesheet(HEADER_HOVER_STYLESHEET);
+            }
+        }
+
+        // open every n-th pane, skip the first so the animation can open it
+        if (openRatio > 0.0) {
+            int every = std::max(1, static_cast<int>(1.0 / openRatio));
+            for (int i = 1; i < panes; i += every) {
+                this->accordion->getContentPane(static_cast<uint>(i))
+                    ->headerTriggered(QPoint());
+            }
+        }
+        this->scrollArea.setWidget(this->accordion);
+        this->scrollArea.show();
+        // finish the open animations and lay everything out
+        this->clock.step(1000);
+        QApplication::processEvents();
+
+        QWidget *viewport = this->scrollArea.viewport();
+        this->image = QImage(viewport->size() * viewport->devicePixelRatio(),
+                             QImage::Format_ARGB32_Premultiplied);
+        this->image.setDevicePixelRatio(viewport->devicePixelRatio());
+    }
+
+    ~PaintBenchmark() { this->clock.uninstall(); }
+
+    void run(int frames)
+    {
+        double full = this->measureFull(frames);
+        double fullPanes = this->visiblePanes();
+        double scrolled = this->measureScrolled(frames);
+        double scrolledPanes = this->visiblePanes();
+        double animated = this->measureAnimation();
+        double animatedPanes = this->visiblePanes();
+
+        std::printf("%8d %6.2f %-9s %-5s %10.3f %10.2f %10.3f %10.2f %10.3f "
+                    "%10.2f\n",
+                    this->panes, this->openRatio, styleName(this->style),
+                    this->cache ? "on" : "off", full,
+                    full * 1000.0 / fullPanes, scrolled,
+                    scrolled * 1000.0 / scrolledPanes, animated,
+                    animated * 1000.0 / animatedPanes);
+        std::fflush(stdout);
+    }
+
+private:
+    int panes;
+    double openRatio;
+    HEADER_STYLE style;
+    bool cache;
+
+    AnimationClock clock;
+    QScrollArea scrollArea;
+    QAccordion *accordion;
+    QImage image;
+
+    double measureFull(int frames)
+    {
+        QWidget *viewport = this->scrollArea.viewport();
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < frames; i++) {
+            viewport->render(&this->image);
+        }
+        return static_cast<double>(timer.nsecsElapsed()) / 1e6 / frames;
+    }
+
+    double measureScrolled(int frames)
+    {
+        const int step = 10;
+        QWidget *viewport = this->scrollArea.viewport();
+        QScrollBar *bar = this->scrollArea.verticalScrollBar();
+        QRegion strip(0, viewport->height() - step, viewport->width(), step);
+        qint64 elapsed = 0;
+        QElapsedTimer timer;
+        for (int i = 0; i < frames; i++) {
+            bar->setValue((i * step) % std::max(1, bar->maximum()));
+            timer.start();
+            viewport->render(&this->image, strip.boundingRect().topLeft(),
+                             strip);
+            elapsed += timer.nsecsElapsed();
+        }
+        return static_cast<double>(elapsed) / 1e6 / frames;
+    }
+
+    double measureAnimation()
+    {
+        QWidget *viewport = this->scrollArea.viewport();
+        this->scrollArea.verticalScrollBar()->setValue(0);
+        QApplication::processEvents();
+
+        ContentPane *cpane = this->accordion->getContentPane(0);
+        const int frames =
+            static_cast<int>(cpane->getAnimationDuration()) / 16 + 1;
+        cpane->headerTriggered(QPoint());
+        qint64 elapsed = 0;
+        QElapsedTimer timer;
+        for (int i = 0; i < frames; i++) {
+            this->clock.step(16);
+            timer.start();
+            // layout of this frame
+            QApplication::processEvents();
+            viewport->render(&this->image);
+            elapsed += timer.nsecsElapsed();
+        }
+        return static_cast<double>(elapsed) / 1e6 / frames;
+    }
+
+    double visiblePanes() const
+    {
+        int top = -this->accordion->y();
+        int bottom = top + this->scrollArea.viewport()->height() - 1;
+        int first = this->accordion->getContentPaneIndexAt(top);
+        int last = this->accordion->getContentPaneIndexAt(bottom);
+        if (first < 0) {
+            return 1.0;
+        }
+        if (last < 0) {
+            last = this->accordion->numberOfContentPanes() - 1;
+        }
+        return std::max(1, last - first + 1);
+    }
+};
+
+int main(int argc, char *argv[])
+{
+    // do not depend on a display
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    int frames = argc > 1 ? std::max(1, QString(argv[1]).toInt()) : 100;
+    std::vector<int> sizes;
+    for (int i = 2; i < argc; i++) {
+        int panes = QString(argv[i]).toInt();
+        if (panes > 0) {
+            sizes.push_back(panes);
+        }
+    }
+    if (sizes.empty()) {
+        sizes = {100, 1000, 10000};
+    }
+
+    std::printf("Milliseconds per frame and microseconds per visible pane\n");
+    std::printf("%8s %6s %-9s %-5s %10s %10s %10s %10s %10s %10s\n",
+                "panes", "open", "style", "cache", "full", "us/pane",
+                "scrolled", "us/pane", "animation", "us/pane");
+    for (int panes : sizes) {
+        for (double openRatio : {0.0, 0.1, 0.5}) {
+            for (HEADER_STYLE style :
+                 {HEADER_STYLE::DEFAULT, HEADER_STYLE::SHARED,
+                  HEADER_STYLE::PER_PANE}) {
+                for (bool cache : {true, false}) {
+                    PaintBenchmark benchmark(panes, openRatio, style, cache);
+                    benchmark.run(frames);
+                }
+            }
+        }
+    }
+    return 0;
+}
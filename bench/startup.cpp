@@ -0,0 +1,46 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+/*
+ * Startup benchmark. Creates an application with an accordion of 100 content
+ * panes, shows it on the offscreen platform and exits once the first frame has
+ * been processed. bench/buildcost.sh runs it repeatedly to compare the process
+ * startup of shared, static and static LTO builds.
+ *
+ * Usage: accordion_bench_startup [number of panes]
+ */
+
+#include <QApplication>
+
+#include "qaccordion/qaccordion.hpp"
+
+int main(int argc, char *argv[])
+{
+    // no window is shown, do not depend on a display
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    int panes = argc > 1 ? QString(argv[1]).toInt() : 100;
+    QAccordion accordion;
+    for (int i = 0; i < panes; i++) {
+        accordion.addContentPane("Content Pane " + QString::number(i));
+    }
+    accordion.resize(400, 600);
+    accordion.show();
+    app.processEvents();
+    return 0;
+}
@@ -19,9 +19,12 @@
 
 #include <QComboBox>
 #include <QGroupBox>
+#include <QHBoxLayout>
+#include <QLabel>
 #include <QLineEdit>
 #include <QMainWindow>
 #include <QPushButton>
+#include <QVBoxLayout>
 
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
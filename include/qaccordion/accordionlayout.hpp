@@ -0,0 +1,201 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ACCORDIONLAYOUT_HPP
+#define ACCORDIONLAYOUT_HPP
+
+#include <QHash>
+#include <QLayout>
+#include <QRect>
+#include <QSet>
+#include <QSize>
+#include <QWidget>
+
+#include <set>
+#include <vector>
+
+#include "qaccordion_config.hpp"
+
+#include "fenwicktree.hpp"
+
+/**
+ * @brief The AccordionLayout class
+ *
+ * @details
+ * Vertical layout used by QAccordion. Items are stacked from top to bottom with
+ * their preferred height (bounded by minimum and maximum height), free space
+ * stays at the bottom of the layout.
+ *
+ * The heights of all items are kept in a FenwickTree. This allows to answer
+ * geometry queries like indexAt() or itemPosition() in O(log n). When the
+ * height of an item changes only the items from this one downwards are moved
+ * during the next layout pass.
+ *
+ * QLayout::invalidate() does not tell which item changed. A widget that knows
+ * its size hint changed reports it with widgetChanged(). Its layout is
+ * activated right away and the invalidation that follows is attributed to
+ * that widget, only its size hint is queried again. Invalidations of unknown
+ * origin, e.g. a changed spacing or a header that got a new icon, update all
+ * items.
+ *
+ * The class is used internally.
+ */
+class AccordionLayout : public QLayout
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief AccordionLayout constructor
+     * @param parent Parent widget or 0
+     */
+    explicit AccordionLayout(QWidget *parent = nullptr);
+    ~AccordionLayout() override;
+
+    /**
+     * @brief Insert a widget at \p index
+     * @param index Position of the widget, -1 appends it
+     * @param widget
+     */
+    void insertWidget(int index, QWidget *widget);
+    /**
+     * @brief Insert several widgets at \p index
+     * @param index Position of the first widget, -1 appends them
+     * @param widgets
+     *
+     * @details
+     * The item heights are updated once for the whole range.
+     */
+    void insertWidgets(int index, const std::vector<QWidget *> &widgets);
+    /**
+     * @brief Remove \p count widgets starting at \p index
+     * @param index
+     * @param count
+     *
+     * @details
+     * The layout items are deleted, the widgets are not. Like insertWidgets()
+     * the item heights are updated once for the whole range.
+     */
+    void removeWidgets(int index, int count);
+    /**
+     * @brief Insert a layout item at \p index
+     * @param index Position of the item, -1 appends it
+     * @param item Layout takes ownership
+     */
+    void insertItem(int index, QLayoutItem *item);
+    /**
+     * @brief Tell the layout that the size hint of \p widget changes
+     * @param widget
+     *
+     * @details
+     * Activates the layout of \p widget now instead of in its next
+     * LayoutRequest. The next layout pass only queries the size hint of this
+     * widget. Content panes call this for every height change of their
+     * container, an animation frame does not touch the other items.
+     */
+    void widgetChanged(QWidget *widget);
+    /**
+     * @brief Get the number of items the last layout update queried
+     * @return int
+     *
+     * @details
+     * Meant for tests and benchmarks.
+     */
+    int getUpdatedItems() const;
+
+    /**
+     * @brief Get the index of the item at vertical position \p y
+     * @param y Position in coordinates of the parent widget
+     * @return Index of the item or -1
+     *
+     * @details
+     * The spacing below an item is considered part of the item. Hidden items
+     * are never returned.
+     */
+    int indexAt(int y) const;
+    /**
+     * @brief Get the vertical position of the item at \p index
+     * @param index
+     * @return Top of the item in coordinates of the parent widget or -1
+     */
+    int itemPosition(int index) const;
+    /**
+     * @brief Get the height of the item at \p index
+     * @param index
+     * @return Height the item gets during a layout pass or -1
+     */
+    int itemHeight(int index) const;
+
+    void addItem(QLayoutItem *item) override;
+    int count() const override;
+    int indexOf(QWidget *widget) const override;
+    QLayoutItem *itemAt(int index) const override;
+    QLayoutItem *takeAt(int index) override;
+
+    Qt::Orientations expandingDirections() const override;
+    QSize sizeHint() const override;
+    QSize minimumSize() const override;
+    void setGeometry(const QRect &rect) override;
+    void invalidate() override;
+
+private:
+    // size of a visible item, height is -1 for hidden ones
+    struct ItemSize {
+        int height;
+        int hintWidth;
+        int minimumWidth;
+        int minimumHeight;
+    };
+
+    std::vector<QLayoutItem *> items;
+
+    // item height plus spacing for every visible item
+    mutable FenwickTree<int> heights;
+    // minimum height plus spacing for every visible item
+    mutable FenwickTree<int> minimumHeights;
+    mutable std::vector<ItemSize> itemSizes;
+    mutable std::multiset<int> hintWidths;
+    mutable std::multiset<int> minimumWidths;
+    mutable int visibleItems;
+    mutable QSize cachedSizeHint;
+    mutable QSize cachedMinimumSize;
+    mutable bool dirty;
+    // all items have to be updated
+    mutable bool fullUpdate;
+    // widgets whose size hint may have changed
+    mutable QSet<QWidget *> dirtyWidgets;
+    // widget whose layout is activated by widgetChanged()
+    QWidget *requestingWidget;
+    // items queried by the last updateHeights()
+    mutable int updatedItems;
+    // first item that has to be moved in the next layout pass
+    mutable std::size_t firstChangedItem;
+
+    // index of every widget, valid in front of firstStaleIndex
+    mutable QHash<QWidget *, std::size_t> widgetIndexes;
+    mutable std::size_t firstStaleIndex;
+
+    QRect lastArea;
+
+    void insertItems(std::size_t index,
+                     const std::vector<QLayoutItem *> &newItems);
+    void structureChanged(std::size_t index);
+    void updateHeights() const;
+    void updateItem(std::size_t index) const;
+    void addItemSize(const ItemSize &size) const;
+    void removeItemSize(const ItemSize &size) const;
+};
+
+#endif  // ACCORDIONLAYOUT_HPP
@@ -0,0 +1,125 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ACCORDIONTRACE_HPP
+#define ACCORDIONTRACE_HPP
+
+#include "qaccordion_config.hpp"
+
+#ifdef QACCORDION_TRACING
+
+#include <QByteArray>
+#include <QString>
+
+#include <cstddef>
+
+/**
+ * @brief Records trace events of accordion operations
+ *
+ * @details
+ * Only available if qAccordion was configured with the CMake option
+ * `QACCORDION_TRACING`. Otherwise the trace macros compile to nothing and this
+ * class does not exist.
+ *
+ * Events are stored in a lock free ring buffer with room for CAPACITY events,
+ * older events are overwritten. Use writeChromeTrace() to dump the buffer in
+ * the Chrome trace event format. The file can be opened with
+ * chrome://tracing or the Perfetto UI.
+ *
+ * qAccordion records begin and end events for adding, inserting, removing and
+ * moving content panes, for handling header clicks, for content factory calls
+ * and for the layout passes of the accordion. Animation frames are recorded as
+ * instant events.
+ */
+class AccordionTrace
+{
+public:
+    /**
+     * @brief Number of events the ring buffer can hold
+     */
+    static const std::size_t CAPACITY = 1 << 16;
+
+    /**
+     * @brief Record the begin of a duration event
+     * @param name Event name, must have static storage duration
+     */
+    static void begin(const char *name);
+    /**
+     * @brief Record the end of a duration event
+     * @param name Event name, must have static storage duration
+     */
+    static void end(const char *name);
+    /**
+     * @brief Record an instant event
+     * @param name Event name, must have static storage duration
+     */
+    static void instant(const char *name);
+
+    /**
+     * @brief Discard all recorded events
+     */
+    static void clear();
+
+    /**
+     * @brief Get the recorded events as Chrome trace JSON
+     * @return QByteArray
+     */
+    static QByteArray toChromeTrace();
+    /**
+     * @brief Write the recorded events as Chrome trace JSON to a file
+     * @param fileName
+     * @return bool False if the file could not be written
+     */
+    static bool writeChromeTrace(const QString &fileName);
+
+private:
+    static void record(const char *name, char phase);
+};
+
+/**
+ * @brief RAII helper that records a begin and an end event
+ */
+class AccordionTraceScope
+{
+public:
+    explicit AccordionTraceScope(const char *name) : name(name)
+    {
+        AccordionTrace::begin(this->name);
+    }
+    ~AccordionTraceScope() { AccordionTrace::end(this->name); }
+
+    AccordionTraceScope(const AccordionTraceScope &) = delete;
+    AccordionTraceScope &operator=(const AccordionTraceScope &) = delete;
+
+private:
+    const char *name;
+};
+
+#define QACCORDION_TRACE_CONCAT_(a, b) a##b
+#define QACCORDION_TRACE_CONCAT(a, b) QACCORDION_TRACE_CONCAT_(a, b)
+#define QACCORDION_TRACE_SCOPE(name)                                           \
+    AccordionTraceScope QACCORDION_TRACE_CONCAT(accordionTraceScope,           \
+                                                __LINE__)(name)
+#define QACCORDION_TRACE_INSTANT(name) AccordionTrace::instant(name)
+
+#else
+
+#define QACCORDION_TRACE_SCOPE(name)
+#define QACCORDION_TRACE_INSTANT(name)
+
+#endif  // QACCORDION_TRACING
+
+#endif  // ACCORDIONTRACE_HPP
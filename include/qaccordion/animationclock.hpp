@@ -0,0 +1,78 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ANIMATIONCLOCK_HPP
+#define ANIMATIONCLOCK_HPP
+
+#include <QAnimationDriver>
+#include <QObject>
+
+#include "qaccordion_config.hpp"
+
+/**
+ * @brief Manually stepped clock for the open and close animations
+ *
+ * @details
+ * Content panes animate with QPropertyAnimation, which is driven by the wall
+ * clock. For tests and benchmarks this makes frames depend on timer accuracy
+ * and system load. Install an AnimationClock to replace the wall clock and
+ * advance all animations frame by frame with step():
+ *
+ * @code
+ * AnimationClock clock;
+ * clock.install();
+ * accordion->getContentPane(0)->headerTriggered(QPoint());
+ * for (int i = 0; i < 20; i++) {
+ *     clock.step(16);
+ *     QApplication::processEvents();  // layout and paint this frame
+ * }
+ * @endcode
+ *
+ * @note
+ * Qt supports one animation driver per thread. While the clock is installed
+ * it drives every animation of the thread, not only the ones of qAccordion.
+ * The clock uninstalls itself when it is destroyed.
+ */
+class AnimationClock : public QAnimationDriver
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief AnimationClock constructor
+     * @param parent Parent object or 0
+     */
+    explicit AnimationClock(QObject *parent = nullptr);
+
+    /**
+     * @brief Advance all running animations
+     * @param milliseconds Time that passes in this frame
+     */
+    void step(qint64 milliseconds);
+
+    /**
+     * @brief Time elapsed since the animations started
+     * @return Milliseconds
+     */
+    qint64 elapsed() const override;
+
+protected:
+    void start() override;
+
+private:
+    qint64 time;
+};
+
+#endif  // ANIMATIONCLOCK_HPP
@@ -0,0 +1,99 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef BACKGROUNDCACHE_HPP
+#define BACKGROUNDCACHE_HPP
+
+#include <QColor>
+#include <QPaintEvent>
+#include <QWidget>
+
+#include "qaccordion_config.hpp"
+
+/**
+ * @brief Cache for the styled background of a widget
+ *
+ * @details
+ * QAccordion and ContentPane draw QStyle::PE_Widget so style sheets work for
+ * them. Drawing the primitive means resolving the style sheet rules on every
+ * paint event. BackgroundCache classifies the background once:
+ *
+ * - Neither a style sheet nor auto fill: nothing is painted and paint events
+ *   return immediately.
+ * - Otherwise the background is drawn into a small probe image as wide as the
+ *   widget. If the probe is fully transparent nothing is painted, if it is a
+ *   single opaque color the exposed region is filled with it.
+ * - Anything else, e.g. gradients, borders or images, is drawn directly and
+ *   clipped to the exposed region, like without the cache.
+ *
+ * A solid background sets Qt::WA_OpaquePaintEvent on the widget so Qt does
+ * not paint the parent below it. The classification does not depend on the
+ * height, so resizing during open and close animations costs nothing. Call
+ * update() when the widget is resized and invalidate() followed by update()
+ * when the style, the palette or the enabled state changes.
+ */
+class BackgroundCache
+{
+public:
+    /**
+     * @brief Classify the background of \p widget
+     * @param widget
+     *
+     * @details
+     * Does nothing unless the cache was invalidated or the width of \p widget
+     * changed.
+     */
+    void update(QWidget *widget);
+    /**
+     * @brief Paint the background of \p widget for \p event
+     * @param widget
+     * @param event
+     */
+    void paint(QWidget *widget, QPaintEvent *event) const;
+    /**
+     * @brief Drop the classification
+     */
+    void invalidate();
+
+    /**
+     * @brief Enable or disable caching for all widgets
+     * @param enabled
+     *
+     * @details
+     * Enabled by default. Disabled caches draw QStyle::PE_Widget on every
+     * paint event. This is meant for benchmarks and should be set before the
+     * widgets are created.
+     */
+    static void setEnabled(bool enabled);
+    /**
+     * @brief Check if caching is enabled
+     * @return bool
+     */
+    static bool getEnabled();
+
+private:
+    enum class STATE { INVALID, EMPTY, SOLID, DIRECT };
+
+    STATE state = STATE::INVALID;
+    int width = -1;
+    QColor color;
+
+    static bool enabled;
+
+    void classify(QWidget *widget);
+};
+
+#endif  // BACKGROUNDCACHE_HPP
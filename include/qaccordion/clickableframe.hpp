@@ -17,16 +17,34 @@
 #ifndef CLICKABLEFRAME_HPP
 #define CLICKABLEFRAME_HPP
 
+#include <QBrush>
+#include <QColor>
 #include <QFrame>
-#include <QGraphicsView>
-#include <QHBoxLayout>
-#include <QLabel>
-#include <QMouseEvent>
+#include <QPixmap>
+#include <QPoint>
 #include <QString>
 #include <qnamespace.h>
 
+#include <memory>
+
 #include "qaccordion_config.hpp"
 
+class QLabel;
+
+/**
+ * @brief Look of the headers shared by all content panes of an accordion
+ *
+ * @details
+ * A header style is applied without Qt style sheets. The header paints its
+ * background itself, the text color is set through the palette of the header.
+ * Qt::NoBrush and an invalid color leave the respective part untouched.
+ */
+struct HeaderStyle {
+    QBrush background;
+    QBrush hoverBackground;
+    QColor textColor;
+};
+
 /**
  * @brief The ClickableFrame class
  *
@@ -85,6 +103,9 @@ public:
     /**
      * @brief Set the default stylesheet
      * @param stylesheet
+     *
+     * @details
+     * The frame stops using the shared style of the accordion.
      */
     void setNormalStylesheet(QString stylesheet);
     /**
@@ -95,6 +116,9 @@ public:
     /**
      * @brief Set mouseover stylesheet
      * @param stylesheet
+     *
+     * @details
+     * The frame stops using the shared style of the accordion.
      */
     void setHoverStylesheet(QString stylesheet);
     /**
@@ -102,6 +126,46 @@ public:
      * @return
      */
     QString getHoverStylesheet();
+    /**
+     * @brief Use the header style of the accordion instead of style sheets
+     * @param shared
+     *
+     * @details
+     * In shared mode the frame has no style sheet of its own and is drawn
+     * with the HeaderStyle set by setHeaderStyle(). This is the default and
+     * saves a style sheet parse per header. Setting a normal or hover style
+     * sheet switches the frame to its own style sheets.
+     */
+    void setSharedStyle(bool shared);
+    /**
+     * @brief Check if the frame uses the shared accordion style
+     * @return bool
+     */
+    bool getSharedStyle() const;
+    /**
+     * @brief Set the shared header style
+     * @param style HeaderStyle or nullptr
+     *
+     * @details
+     * QAccordion hands the same style object to all of its headers. The style
+     * is only used in shared mode, see setSharedStyle().
+     */
+    void setHeaderStyle(std::shared_ptr<const HeaderStyle> style);
+    /**
+     * @brief Get the shared header style
+     * @return HeaderStyle or nullptr
+     */
+    std::shared_ptr<const HeaderStyle> getHeaderStyle() const;
+    /**
+     * @brief Change the mouse over state of the frame
+     * @param hovered
+     *
+     * @details
+     * Applies the hover or normal style. The frame does not track the mouse
+     * itself, QAccordion resolves the header under the cursor and calls this
+     * method for the previous and the new hovered header only.
+     */
+    void setHovered(bool hovered);
 
 signals:
     /**
@@ -109,6 +173,14 @@ signals:
      * @param pos Currently unused
      */
     void triggered(QPoint pos);
+    /**
+     * @brief Signal that is emitted when the frame looks different
+     *
+     * @details
+     * Emitted for a new header text or icon, mouse over and changes of the
+     * style, palette or font. StickyHeader grabs the frame again.
+     */
+    void appearanceChanged();
 
 public slots:
 
@@ -139,7 +211,12 @@ private:
 
     TRIGGER headerTrigger;
 
+    bool sharedStyle;
+    bool hovered;
+    std::shared_ptr<const HeaderStyle> headerStyle;
+
     void initFrame();
+    void applyTextColor();
 
 protected:
     /**
@@ -148,17 +225,16 @@ protected:
      */
     void mousePressEvent(QMouseEvent *event) override;
     void mouseDoubleClickEvent(QMouseEvent *event) override;
-
     /**
-     * @brief Enter event for mouse over effects.
+     * @brief Emit appearanceChanged() on style, palette and font changes
      * @param event
      */
-    void enterEvent(QEvent *event) override;
+    void changeEvent(QEvent *event) override;
     /**
-     * @brief Leave effect for mouse over effects.
+     * @brief Paint the background of the shared header style
      * @param event
      */
-    void leaveEvent(QEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
 };
 
 #endif  // CLICKABLEFRAME_HPP
@@ -18,21 +18,36 @@
 #define CONTENTPANE_HPP
 
 #include <QFrame>
-#include <QHBoxLayout>
-#include <QPainter>
+#include <QImage>
+#include <QPixmap>
 #include <QPoint>
-#include <QPropertyAnimation>
 #include <QString>
-#include <QStyleOption>
 #include <QWidget>
 
+#include <functional>
 #include <memory>
 
 #include "qaccordion_config.hpp"
 
 #include "clickableframe.hpp"
+#include "memoryfootprint.hpp"
+#include "slotmap.hpp"
 // #include "qaccordion.hpp"
 
+struct ContentPanePrivate;
+
+/**
+ * @brief Stable handle to a ContentPane managed by a QAccordion
+ *
+ * @details
+ * Other than indexes a PaneHandle stays valid when content panes are inserted,
+ * removed or moved. Once the ContentPane is removed from the accordion the
+ * handle becomes stale and will no longer resolve.
+ * @sa
+ * QAccordion::getContentPaneHandle()
+ */
+using PaneHandle = SlotHandle;
+
 /**
  * @brief Content Pane class
  *
@@ -61,6 +76,14 @@
  *
  * @details
  * The animation speed is influenceable setAnimationDuration().
+ *
+ * @details
+ * A QAccordion may be placed in the content frame of a ContentPane. The outer
+ * pane follows the height changes of the inner content panes, also while they
+ * are animated. Changes are collected and applied once per event loop
+ * iteration, so a frame costs one update per nesting level no matter how many
+ * inner panes are moving. Nesting stops at a QAbstractScrollArea, the scroll
+ * area absorbs the height changes.
  */
 class ContentPane : public QWidget
 {
@@ -79,6 +102,7 @@ public:
      * @param parent Parent widget or 0
      */
     explicit ContentPane(QString header, QFrame *content, QWidget *parent = nullptr);
+    ~ContentPane() override;
 
     /**
      * @brief Check if this Content pane is active
@@ -103,6 +127,58 @@ public:
      * lifecycle
      */
     void setContentFrame(QFrame *content);
+    /**
+     * @brief Create the content frame on demand
+     * @param factory Function that returns the content QFrame*
+     *
+     * @details
+     * Instead of building the content up front you may provide a \p factory.
+     * It is called once, right before the content pane is opened for the first
+     * time, and its result is used as content frame. If the factory returns a
+     * __nullptr__ the current content frame is kept. Calling setContentFrame()
+     * discards a factory that has not been called yet.
+     */
+    void setContentFactory(std::function<QFrame *()> factory);
+    /**
+     * @brief Check if a content factory is waiting to be called
+     * @return bool
+     */
+    bool hasContentFactory() const;
+    /**
+     * @brief Call the content factory now
+     *
+     * @details
+     * Builds the content immediately instead of waiting until the content pane
+     * is opened. Does nothing if there is no content factory.
+     */
+    void createContent();
+    /**
+     * @brief Show a pre-rendered image while the content is being built
+     * @param renderer Function that renders a preview of the content for the
+     * given width
+     *
+     * @details
+     * Only useful together with setContentFactory(). The \p renderer is called
+     * on a thread pool with the width of the content pane, right away if the
+     * pane has been laid out already and otherwise on its first resize. When
+     * the width changes before the content is built the preview is rendered
+     * again. The \p renderer must not create or access widgets, set
+     * QImage::setDevicePixelRatio() on the result for high dpi screens. If a
+     * preview for the current width is ready when the content pane is opened
+     * for the first time it is shown instead of the content and the content
+     * factory is called after the first frame has been painted. The content
+     * frame then replaces the preview. If the factory returns a __nullptr__
+     * the previous content frame is shown again.
+     *
+     * If the preview is not ready yet the content is built right away as
+     * usual.
+     */
+    void setPreviewRenderer(std::function<QImage(int width)> renderer);
+    /**
+     * @brief Check if a preview for the current width is ready to be shown
+     * @return bool
+     */
+    bool hasPreview() const;
 
     /**
      * @brief Get the maximum height of the content pane container frame
@@ -124,6 +200,44 @@ public:
      * container or for example by adding a [QScrollArea](http://doc.qt.io/qt-5.5/qscrollarea.html).
      */
     void setMaximumHeight(int maxHeight);
+    /**
+     * @brief Size the container to fit the content
+     * @param autoHeight
+     *
+     * @details
+     * With automatic height the container height is measured from the size
+     * hint of the content frame every time the content pane is opened.
+     * Calling setMaximumHeight() switches automatic height off.
+     *
+     * Measuring complex content takes time. If the accordion has a
+     * HeightCache (QAccordion::setHeightCache()) the height is taken from the
+     * cache on the first open. On a hit the animation starts right away, a
+     * pending content factory is only called after the first frame and the
+     * height is measured after the content pane has been opened. A stale
+     * entry is corrected then.
+     * @note
+     * Default value for this option is \p false.
+     */
+    void setAutoHeight(bool autoHeight);
+    /**
+     * @brief Check if automatic height is enabled
+     * @return bool
+     */
+    bool getAutoHeight() const;
+    /**
+     * @brief Set the type of the content for the HeightCache key
+     * @param contentType
+     *
+     * @details
+     * Set a type when content panes with the same header may show different
+     * content, e.g. the name of the class your content factory creates.
+     */
+    void setContentType(QString contentType);
+    /**
+     * @brief Get the type of the content
+     * @return QString
+     */
+    QString getContentType() const;
 
     void setTrigger(ClickableFrame::TRIGGER tr);
     ClickableFrame::TRIGGER getTrigger();
@@ -164,6 +278,18 @@ public:
      * @return QPixmap
      */
     QPixmap getHeaderIconActive();
+    /**
+     * @brief Load the active header icon without blocking the GUI thread
+     * @param icon Path to image
+     *
+     * @details
+     * The image is decoded on a thread pool by ImageLoader, the current icon
+     * stays visible until it has been loaded. Content panes that use the same
+     * path share one decode and one pixmap. Like setHeaderIconActive(QString)
+     * the icon is not changed if the image can not be read. Setting another
+     * active icon before the image has been loaded discards it.
+     */
+    void setHeaderIconActiveAsync(const QString &icon);
     /**
      * @brief et the header icon that will be displayed when the content pane is inactive
      * @param icon Path to image
@@ -187,6 +313,12 @@ public:
      * @return QPixmap
      */
     QPixmap getHeaderIconInActive();
+    /**
+     * @brief Load the inactive header icon without blocking the GUI thread
+     * @param icon Path to image
+     * @sa setHeaderIconActiveAsync()
+     */
+    void setHeaderIconInActiveAsync(const QString &icon);
     /**
      * @brief Set header tooltip
      * @param tooltip String to show as tooltip
@@ -212,6 +344,10 @@ public:
      * You can use [Cascading Style Sheets](http://doc.qt.io/qt-5/stylesheet.html) as supported by Qt to
      * style the header. This is the standard style sheet. You may also set a
      * style for mouse over with setHeaderHoverStylesheet().
+     *
+     * @note
+     * Every header with an own style sheet is styled separately by Qt. If all
+     * headers look the same use QAccordion::setHeaderStyle() instead.
      */
     void setHeaderStylesheet(QString stylesheet);
     /**
@@ -241,6 +377,23 @@ public:
      * Returns the mouse over header style sheet.
      */
     QString getHeaderHoverStylesheet();
+    /**
+     * @brief Use the header style of the accordion
+     * @param shared
+     *
+     * @details
+     * Headers use the style set with QAccordion::setHeaderStyle() until
+     * setHeaderStylesheet() or setHeaderHoverStylesheet() is called on this
+     * content pane. Pass
+     * __true__ to drop the style sheets of this header and use the shared
+     * style again.
+     */
+    void setHeaderSharedStyle(bool shared);
+    /**
+     * @brief Check if the header uses the style of the accordion
+     * @return bool
+     */
+    bool getHeaderSharedStyle() const;
     /**
      * @brief Set the header frame style
      * @param style
@@ -288,18 +441,47 @@ public:
      */
     uint getAnimationDuration();
 
+    /**
+     * @brief Estimate the memory used by this content pane
+     * @return MemoryFootprint
+     *
+     * @details
+     * Walks the widgets, layouts and animations of the content pane and sums
+     * up their estimated size together with strings and pixmaps. Everything
+     * below the content frame is accounted to MemoryFootprint::content.
+     * @sa
+     * MemoryFootprint for the accuracy of the values.
+     */
+    MemoryFootprint getMemoryFootprint() const;
+
 signals:
 
     /**
      * @brief Clicked signal is emitted when the header is clicked
      */
     void clicked();
+    /**
+     * @brief Signal will be emitted when the content pane starts to open
+     *
+     * @details
+     * The signal is emitted before the open animation starts, connect to it to
+     * bring the content up to date before it becomes visible.
+     */
+    void aboutToOpen();
     /**
      * @brief Signal will be emitted after the open animation finished
+     *
+     * @details
+     * Without animation the signal is emitted right after the content pane
+     * has been opened.
      */
     void isActive();
     /**
      * @brief Signal will be emitted after the close animation finished
+     *
+     * @details
+     * Without animation the signal is emitted right after the content pane
+     * has been closed.
      */
     void isInactive();
 
@@ -324,26 +506,38 @@ private:
     // closeContentPane private
     friend class QAccordion;
 
-    ClickableFrame *header;
-    QFrame *container;
-    QFrame *content;
-
-    QPixmap headerIconActive;
-    QPixmap headerIconInActive;
-
-    int headerFrameStyle;
-    int contentPaneFrameStyle;
-    int containerAnimationMaxHeight;
-
-    bool active;
-
-    std::unique_ptr<QPropertyAnimation> openAnimation;
-    std::unique_ptr<QPropertyAnimation> closeAnimation;
+    std::unique_ptr<ContentPanePrivate> d;
 
     void initDefaults(QString header);
     void initHeaderFrame(QString header);
     void initContainerContentFrame();
     void initAnimations();
+    void setAnimated(bool animated);
+    void setActiveState(bool active);
+    void emitActiveState();
+    void releaseAnimations();
+    void showPreview();
+    void renderPreview();
+    void applyMaximumHeight(int maxHeight);
+    void applyMeasuredHeight(int height);
+    int getOpenHeight() const;
+    void applyOpenHeight();
+    QString heightKey();
+    int measureHeight() const;
+    bool applyCachedHeight();
+    void updateAutoHeight();
+    void verifyHeight();
+    int getFrameTime() const;
+    void setContainerHeight(int height);
+    void containerHeightChanged();
+    void detachOuterPane();
+    ContentPane *getOuterPane() const;
+    void nestedHeightChanged(int delta, bool now);
+    void updateNestedHeight();
+
+    void addMemoryFootprint(MemoryFootprint &footprint,
+                            QSet<qint64> &pixmapKeys) const;
+    bool isContentObject(const QObject *object) const;
 
 private slots:
 
@@ -365,13 +559,40 @@ private slots:
      * This will close the content pane if it is currently open.
      */
     void closeContentPane();
+    void animationFinished();
 
 protected:
     /**
      * @brief paintEvent Reimplement paintEvent to use stylesheets in derived Widgets
      * @param event
+     *
+     * @details
+     * The styled background is classified once, only the exposed region is
+     * painted.
+     * @sa
+     * BackgroundCache
+     */
+    void paintEvent(QPaintEvent *event) override;
+    /**
+     * @brief Invalidate the cached background on style and palette changes
+     * @param event
+     */
+    void changeEvent(QEvent *event) override;
+    /**
+     * @brief Update the cached background when the width changes
+     * @param event
+     */
+    void resizeEvent(QResizeEvent *event) override;
+    /**
+     * @brief Size the container for content of \p height
+     * @param height Height of the content frame
+     *
+     * @details
+     * For subclasses that know the height of their content without a layout
+     * pass. The frame of the container is added to \p height. Automatic
+     * height is switched off.
      */
-    void paintEvent(ATTR_UNUSED QPaintEvent *event) override;
+    void setContentHeight(int height);
 };
 
 #endif  // CONTENTPANE_HPP
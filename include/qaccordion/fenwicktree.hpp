@@ -0,0 +1,217 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FENWICKTREE_HPP
+#define FENWICKTREE_HPP
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Fenwick tree (binary indexed tree) over a sequence of values
+ *
+ * @details
+ * Stores a sequence of non negative values and answers prefix sum queries in
+ * O(log n). Changing a single value is O(log n) as well. Inserting or erasing
+ * values shifts all following elements. Only the nodes behind the changed
+ * position are rebuilt, appending or removing at the end is O(log n), inserting
+ * k values in front of m values is O(k + m + log² n).
+ *
+ * AccordionLayout uses this class to store the heights of its items.
+ */
+template <typename T>
+class FenwickTree
+{
+public:
+    FenwickTree() = default;
+
+    /**
+     * @brief Replace all values and rebuild the tree
+     * @param values New values
+     */
+    void assign(std::vector<T> values)
+    {
+        this->values = std::move(values);
+        this->rebuild();
+    }
+
+    /**
+     * @brief Insert a value at \p index
+     * @param index Position of the new value
+     * @param value
+     */
+    void insert(std::size_t index, T value) { this->insert(index, 1, value); }
+
+    /**
+     * @brief Insert \p count copies of \p value at \p index
+     * @param index Position of the first new value
+     * @param count
+     * @param value
+     */
+    void insert(std::size_t index, std::size_t count, T value)
+    {
+        this->values.insert(this->values.begin() + index, count, value);
+        this->rebuildFrom(index);
+    }
+
+    /**
+     * @brief Erase the value at \p index
+     * @param index
+     */
+    void erase(std::size_t index) { this->erase(index, 1); }
+
+    /**
+     * @brief Erase \p count values starting at \p index
+     * @param index
+     * @param count
+     */
+    void erase(std::size_t index, std::size_t count)
+    {
+        this->values.erase(this->values.begin() + index,
+                           this->values.begin() + index + count);
+        this->rebuildFrom(index);
+    }
+
+    /**
+     * @brief Change the value at \p index
+     * @param index
+     * @param value
+     */
+    void set(std::size_t index, T value)
+    {
+        T delta = value - this->values[index];
+        if (delta == T()) {
+            return;
+        }
+        this->values[index] = value;
+        for (std::size_t i = index + 1; i <= this->values.size();
+             i += i & (~i + 1)) {
+            this->tree[i] += delta;
+        }
+    }
+
+    /**
+     * @brief Get the value at \p index
+     * @param index
+     * @return T
+     */
+    T value(std::size_t index) const { return this->values[index]; }
+
+    /**
+     * @brief Sum of the first \p count values
+     * @param count Number of values, may be size()
+     * @return T
+     */
+    T prefixSum(std::size_t count) const
+    {
+        T sum = T();
+        for (std::size_t i = count; i > 0; i -= i & (~i + 1)) {
+            sum += this->tree[i];
+        }
+        return sum;
+    }
+
+    /**
+     * @brief Sum of all values
+     * @return T
+     */
+    T total() const { return this->prefixSum(this->values.size()); }
+
+    /**
+     * @brief Find the element that covers \p offset
+     * @param offset
+     * @return Index of the element or size() if \p offset is behind the last
+     * element
+     *
+     * @details
+     * Returns the smallest index i for which prefixSum(i + 1) > \p offset. If
+     * you think of the values as heights stacked on top of each other this is
+     * the element at position \p offset.
+     */
+    std::size_t find(T offset) const
+    {
+        std::size_t pos = 0;
+        std::size_t step = 1;
+        while (step * 2 <= this->values.size()) {
+            step *= 2;
+        }
+        for (; step > 0; step /= 2) {
+            if (pos + step <= this->values.size() &&
+                this->tree[pos + step] <= offset) {
+                pos += step;
+                offset -= this->tree[pos];
+            }
+        }
+        return pos;
+    }
+
+    /**
+     * @brief Number of values
+     * @return std::size_t
+     */
+    std::size_t size() const { return this->values.size(); }
+
+    /**
+     * @brief Remove all values
+     */
+    void clear()
+    {
+        this->values.clear();
+        this->tree.assign(1, T());
+    }
+
+private:
+    std::vector<T> values;
+    // one based, tree[0] is unused
+    std::vector<T> tree = std::vector<T>(1, T());
+
+    void rebuild()
+    {
+        // linear time construction, every node pushes its sum to the parent
+        this->tree.assign(this->values.size() + 1, T());
+        for (std::size_t i = 1; i <= this->values.size(); i++) {
+            this->tree[i] += this->values[i - 1];
+            std::size_t parent = i + (i & (~i + 1));
+            if (parent <= this->values.size()) {
+                this->tree[parent] += this->tree[i];
+            }
+        }
+    }
+
+    void rebuildFrom(std::size_t index)
+    {
+        // nodes up to index only cover values in front of index and are still
+        // valid. node p covers the values (p - lowbit(p), p], its sum is the
+        // difference of two prefix sums.
+        const std::size_t size = this->values.size();
+        this->tree.resize(size + 1);
+        std::vector<T> sums;
+        sums.reserve(size - index + 1);
+        sums.push_back(this->prefixSum(index));
+        for (std::size_t i = index; i < size; i++) {
+            sums.push_back(sums.back() + this->values[i]);
+        }
+        for (std::size_t p = index + 1; p <= size; p++) {
+            std::size_t low = p - (p & (~p + 1));
+            // only the O(log n) nodes that reach over index need a query
+            T before =
+                low >= index ? sums[low - index] : this->prefixSum(low);
+            this->tree[p] = sums[p - index] - before;
+        }
+    }
+};
+
+#endif  // FENWICKTREE_HPP
@@ -0,0 +1,121 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEIGHTCACHE_HPP
+#define HEIGHTCACHE_HPP
+
+#include <QFont>
+#include <QHash>
+#include <QString>
+
+#include "qaccordion_config.hpp"
+
+/**
+ * @brief Measured content heights that survive the application
+ *
+ * @details
+ * Content panes with automatic height (ContentPane::setAutoHeight()) measure
+ * their content when they are opened. With a HeightCache set on the
+ * accordion (QAccordion::setHeightCache()) the measured heights are stored
+ * and used the next time, so a content pane can be laid out and animated
+ * before its content is built. A cached height is verified after the content
+ * pane has been opened for the first time and corrected if it is stale.
+ *
+ * Entries are keyed by header, content type, width and font of the content
+ * pane and the device pixel ratio of the screen (see makeKey()). Use load()
+ * at startup and save() before the application quits.
+ *
+ * In case of an error you may get a more detailed error description with
+ * getError().
+ */
+class HeightCache
+{
+public:
+    HeightCache() = default;
+
+    /**
+     * @brief Build the key of a content pane
+     * @param header Header or key of the content pane
+     * @param contentType Type of the content, see ContentPane::setContentType()
+     * @param width Width of the content pane, rounded down to a multiple of
+     * WIDTH_BUCKET
+     * @param font Font of the content pane
+     * @param devicePixelRatio
+     * @return QString
+     */
+    static QString makeKey(const QString &header, const QString &contentType,
+                           int width, const QFont &font,
+                           qreal devicePixelRatio);
+
+    /**
+     * @brief Get the cached height of a key
+     * @param key
+     * @return int, -1 if there is no entry
+     */
+    int lookup(const QString &key) const;
+    /**
+     * @brief Store a measured height
+     * @param key
+     * @param height
+     */
+    void insert(const QString &key, int height);
+    /**
+     * @brief Remove a stale entry
+     * @param key
+     */
+    void remove(const QString &key);
+    /**
+     * @brief Remove all entries
+     */
+    void clear();
+    /**
+     * @brief Number of entries
+     * @return int
+     */
+    int size() const;
+
+    /**
+     * @brief Read the cache from \p fileName
+     * @param fileName
+     * @return bool, false if the file can not be read. The current entries are
+     * kept in this case
+     *
+     * @details
+     * A file that does not exist is not an error, the cache is empty then.
+     */
+    bool load(const QString &fileName);
+    /**
+     * @brief Write the cache to \p fileName
+     * @param fileName
+     * @return bool
+     */
+    bool save(const QString &fileName);
+
+    /**
+     * @brief Get error string
+     * @return Error string
+     */
+    QString getError() const;
+
+    // content panes with a width in the same bucket share an entry
+    static const int WIDTH_BUCKET = 32;
+
+private:
+    QHash<QString, int> heights;
+    QString errorString;
+};
+
+#endif  // HEIGHTCACHE_HPP
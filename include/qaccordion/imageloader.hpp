@@ -0,0 +1,111 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef IMAGELOADER_HPP
+#define IMAGELOADER_HPP
+
+#include <QHash>
+#include <QImage>
+#include <QObject>
+#include <QPixmap>
+#include <QPointer>
+#include <QString>
+#include <QThreadPool>
+
+#include <functional>
+#include <vector>
+
+#include "qaccordion_config.hpp"
+
+/**
+ * @brief Decode images on a thread pool
+ *
+ * @details
+ * Loading a QPixmap from a slow file system blocks the GUI thread.
+ * ImageLoader reads and decodes images with QImageReader on its own thread
+ * pool and converts them to a QPixmap on the GUI thread. Requests for a path
+ * that is already being decoded wait for the same result, decoded pixmaps
+ * are kept in QPixmapCache. The class is used internally by
+ * ContentPane::setHeaderIconActiveAsync() and
+ * ContentPane::setHeaderIconInActiveAsync(). render() runs arbitrary
+ * image producing functions on the same pool, it is used for the content
+ * previews of ContentPane::setPreviewRenderer().
+ *
+ * All methods have to be called from the GUI thread.
+ */
+class ImageLoader : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief Get the image loader of the application
+     * @return ImageLoader*
+     *
+     * @details
+     * The loader is created on first use and deleted with the application
+     * object.
+     */
+    static ImageLoader *instance();
+
+    /**
+     * @brief Load the image at \p path
+     * @param path Path of the image file
+     * @param receiver The callback is dropped if this object is deleted
+     * @param callback Called on the GUI thread with the pixmap, which is null
+     * if the image could not be read
+     *
+     * @details
+     * If the pixmap is in QPixmapCache the callback is called before load()
+     * returns.
+     */
+    void load(const QString &path, QObject *receiver,
+              std::function<void(const QPixmap &)> callback);
+    /**
+     * @brief Run \p renderer on the thread pool
+     * @param renderer Function that produces an image. It must not touch
+     * widgets or other GUI thread objects
+     * @param receiver The callback is dropped if this object is deleted
+     * @param callback Called on the GUI thread with the rendered image
+     */
+    void render(std::function<QImage()> renderer, QObject *receiver,
+                std::function<void(const QImage &)> callback);
+
+private:
+    struct Request {
+        QPointer<QObject> receiver;
+        std::function<void(const QPixmap &)> callback;
+    };
+
+    QThreadPool pool;
+    // requests waiting for a path that is being decoded
+    QHash<QString, std::vector<Request>> pending;
+
+    struct RenderRequest {
+        QPointer<QObject> receiver;
+        std::function<void(const QImage &)> callback;
+    };
+    QHash<quint64, RenderRequest> renders;
+    quint64 nextRender;
+
+    explicit ImageLoader(QObject *parent = nullptr);
+    ~ImageLoader() override;
+
+private slots:
+    void deliver(const QString &path, const QImage &image);
+    void deliverRender(quint64 id, const QImage &image);
+};
+
+#endif  // IMAGELOADER_HPP
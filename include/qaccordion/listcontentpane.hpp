@@ -0,0 +1,180 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef LISTCONTENTPANE_HPP
+#define LISTCONTENTPANE_HPP
+
+#include <QAbstractItemModel>
+#include <QListView>
+#include <QPointer>
+#include <QString>
+#include <QStringList>
+#include <QWidget>
+
+#include <functional>
+
+#include "qaccordion_config.hpp"
+
+#include "contentpane.hpp"
+
+class ListContentModel;
+
+/**
+ * @brief ContentPane that shows a list of rows
+ *
+ * @details
+ * A QVBoxLayout with one QLabel per row creates a widget for every row.
+ * ListContentPane uses a QListView with uniform row heights as content frame
+ * instead. Only the visible rows are painted and the number of widgets does
+ * not depend on the number of rows.
+ *
+ * The rows come from
+ * * appendRows(), which stores them in an internal model. At most
+ *   getMaximumRows() rows are kept, the oldest ones are dropped,
+ * * a data source (setDataSource()) that is asked for the next batch of rows
+ *   when the user scrolls to the end of the list. Its rows are not stored,
+ *   only the pages around the visible rows are kept and requested again when
+ *   needed, or
+ * * your own model (setModel()). The view calls QAbstractItemModel::fetchMore()
+ *   of the model when the end of the list is reached.
+ *
+ * The container is sized to min(rows, getMaximumVisibleRows()) times the row
+ * height and follows the number of rows.
+ */
+class ListContentPane : public ContentPane
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief ListContentPane constructor
+     * @param header The Header of the content pane
+     * @param parent Parent widget or 0
+     */
+    explicit ListContentPane(QString header, QWidget *parent = nullptr);
+    /**
+     * @brief ListContentPane constructor
+     * @param header The Header of the content pane
+     * @param content QListView to use as list view or nullptr to create one.
+     * Other frames are not used.
+     * @param parent Parent widget or 0
+     *
+     * @details
+     * This is the constructor QAccordionT<ListContentPane> uses.
+     */
+    ListContentPane(QString header, QFrame *content,
+                    QWidget *parent = nullptr);
+    ~ListContentPane() override;
+
+    /**
+     * @brief Append rows to the internal model
+     * @param rows
+     *
+     * @details
+     * Switches back to the internal model if setModel() was used. Rows of a
+     * data source are removed together with the data source.
+     */
+    void appendRows(const QStringList &rows);
+    /**
+     * @brief Remove all rows and the data source of the internal model
+     */
+    void clearRows();
+    /**
+     * @brief Stream rows from a data source
+     * @param source Function that returns up to \p count rows starting at row
+     * \p first
+     * @param batchSize Number of rows requested at once
+     *
+     * @details
+     * The first batch is requested right away, the following ones when the
+     * user scrolls to the end of the list. A batch with less than \p batchSize
+     * rows ends the stream. Rows added with appendRows() are removed.
+     *
+     * The rows are not stored. Only a few pages of \p batchSize rows around
+     * the visible ones are kept, \p source has to return the same rows when it
+     * is asked for a page again.
+     */
+    void setDataSource(std::function<QStringList(int first, int count)> source,
+                       int batchSize = 100);
+    /**
+     * @brief Show your own model
+     * @param model The model is not owned by the content pane. Pass nullptr to
+     * switch back to the internal model
+     */
+    void setModel(QAbstractItemModel *model);
+    /**
+     * @brief Get the model that is shown
+     * @return QAbstractItemModel*
+     */
+    QAbstractItemModel *getModel() const;
+    /**
+     * @brief Get the list view
+     * @return QListView*
+     *
+     * @details
+     * Use this to change selection behavior or the item delegate. Keep uniform
+     * item sizes enabled, the height of the container relies on it.
+     */
+    QListView *getListView() const;
+
+    /**
+     * @brief Set the maximum number of rows appendRows() keeps
+     * @param rows
+     *
+     * @details
+     * When the maximum is exceeded the oldest rows are dropped. Rows of a data
+     * source are not stored and not limited.
+     * @note
+     * Default value for this option is 100000.
+     */
+    void setMaximumRows(int rows);
+    /**
+     * @brief Get the maximum number of rows appendRows() keeps
+     * @return int
+     */
+    int getMaximumRows() const;
+
+    /**
+     * @brief Set the number of rows that are visible without scrolling
+     * @param rows
+     * @note
+     * Default value for this option is 10.
+     */
+    void setMaximumVisibleRows(int rows);
+    /**
+     * @brief Get the number of rows that are visible without scrolling
+     * @return int
+     */
+    int getMaximumVisibleRows() const;
+
+private:
+    QListView *view;
+    ListContentModel *listModel;
+    QPointer<QAbstractItemModel> model;
+    int maximumVisibleRows;
+
+    void initList(QListView *view);
+    void connectModel(QAbstractItemModel *model);
+    void updateHeight();
+
+protected:
+    /**
+     * @brief Update the height when the font changes
+     * @param event
+     */
+    void changeEvent(QEvent *event) override;
+};
+
+#endif  // LISTCONTENTPANE_HPP
@@ -0,0 +1,137 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef LOGCONTENTPANE_HPP
+#define LOGCONTENTPANE_HPP
+
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <QWidget>
+
+#include "qaccordion_config.hpp"
+
+#include "contentpane.hpp"
+
+class LogView;
+
+/**
+ * @brief ContentPane that shows a stream of log lines
+ *
+ * @details
+ * LogContentPane is meant for high rate, append only text like the log output
+ * of one component. Lines are stored in fixed size chunks that are recycled
+ * once the maximum number of lines is reached, so the memory of a pane is
+ * bounded by getMaximumLines(). Only the visible lines are painted and their
+ * glyph layout is cached.
+ *
+ * Appending a line never triggers a repaint directly. All lines appended
+ * within one frame are painted together. While the pane is closed lines are
+ * only stored, the view catches up when the pane is opened.
+ *
+ * The view follows the newest line as long as it is scrolled to the bottom.
+ */
+class LogContentPane : public ContentPane
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief LogContentPane constructor
+     * @param header The Header of the content pane
+     * @param parent Parent widget or 0
+     */
+    explicit LogContentPane(QString header, QWidget *parent = nullptr);
+    /**
+     * @brief LogContentPane constructor
+     * @param header The Header of the content pane
+     * @param content Not used, the pane always creates its own log view
+     * @param parent Parent widget or 0
+     *
+     * @details
+     * This is the constructor QAccordionT<LogContentPane> uses.
+     */
+    LogContentPane(QString header, QFrame *content, QWidget *parent = nullptr);
+    ~LogContentPane() override;
+
+    /**
+     * @brief Append a line
+     * @param line
+     */
+    void appendLine(const QString &line);
+    /**
+     * @brief Append several lines
+     * @param lines
+     */
+    void appendLines(const QStringList &lines);
+    /**
+     * @brief Remove all lines
+     */
+    void clear();
+    /**
+     * @brief Get the number of stored lines
+     * @return int
+     */
+    int getLineCount() const;
+
+    /**
+     * @brief Set the maximum number of stored lines
+     * @param lines
+     *
+     * @details
+     * When the maximum is exceeded the oldest lines are dropped. Lines are
+     * dropped in chunks, up to one chunk more than \p lines may be kept.
+     * @note
+     * Default value for this option is 100000.
+     */
+    void setMaximumLines(int lines);
+    /**
+     * @brief Get the maximum number of stored lines
+     * @return int
+     */
+    int getMaximumLines() const;
+
+    /**
+     * @brief Set the number of lines that are visible without scrolling
+     * @param lines
+     * @note
+     * Default value for this option is 15.
+     */
+    void setVisibleLines(int lines);
+    /**
+     * @brief Get the number of lines that are visible without scrolling
+     * @return int
+     */
+    int getVisibleLines() const;
+
+private:
+    LogView *view;
+    QTimer frameTimer;
+    int visibleLines;
+
+    void initLog();
+    void scheduleFrame();
+    void flush();
+    void updateHeight();
+
+protected:
+    /**
+     * @brief Update the height when the font changes
+     * @param event
+     */
+    void changeEvent(QEvent *event) override;
+};
+
+#endif  // LOGCONTENTPANE_HPP
@@ -0,0 +1,84 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef MEMORYFOOTPRINT_HPP
+#define MEMORYFOOTPRINT_HPP
+
+#include <QObject>
+#include <QPixmap>
+#include <QSet>
+#include <QString>
+
+#include <cstddef>
+
+#include "qaccordion_config.hpp"
+
+/**
+ * @brief Estimated memory footprint broken down by component
+ *
+ * @details
+ * Returned by ContentPane::getMemoryFootprint() and
+ * QAccordion::getMemoryFootprint(). All values are in bytes.
+ *
+ * Qt does not expose the size of the private data of its objects, these
+ * values are approximations for a 64 bit build of Qt 5. Pixmaps are counted
+ * with their pixel data, implicitly shared pixmaps are only counted once.
+ * The values are meant to compare different object graphs of a content pane,
+ * not to replace a heap profiler.
+ */
+struct MemoryFootprint {
+    std::size_t widgets = 0;    /**< Widgets of the pane, without content */
+    std::size_t layouts = 0;    /**< Layouts and their layout items */
+    std::size_t animations = 0; /**< Open and close animations */
+    std::size_t pixmaps = 0;    /**< Header icons and label pixmaps */
+    std::size_t strings = 0;    /**< Header, tooltip and style sheets */
+    std::size_t content = 0;    /**< Content frame and all its children */
+    std::size_t other = 0;      /**< Other objects and bookkeeping */
+
+    /**
+     * @brief Sum of all components
+     * @return std::size_t
+     */
+    std::size_t total() const;
+
+    MemoryFootprint &operator+=(const MemoryFootprint &other);
+
+    /**
+     * @brief Estimate the size of an object including its private data
+     * @param object
+     * @return std::size_t
+     *
+     * @details
+     * Strings and pixmaps the object holds are not included.
+     */
+    static std::size_t estimateObject(const QObject *object);
+    /**
+     * @brief Estimate the size of the string data
+     * @param string
+     * @return std::size_t
+     */
+    static std::size_t estimateString(const QString &string);
+    /**
+     * @brief Estimate the size of the pixel data of a pixmap
+     * @param pixmap
+     * @param seen Cache keys of pixmaps that have already been counted
+     * @return std::size_t, 0 if the pixmap is in \p seen
+     */
+    static std::size_t estimatePixmap(const QPixmap &pixmap,
+                                      QSet<qint64> &seen);
+};
+
+#endif  // MEMORYFOOTPRINT_HPP
@@ -17,26 +17,39 @@
 #ifndef QACCORDION_HPP
 #define QACCORDION_HPP
 
-#include <QDebug>
-#include <QGridLayout>
-#include <QHBoxLayout>
-#include <QPainter>
-#include <QSpacerItem>
+#include <QByteArray>
 #include <QString>
-#include <QStyleOption>
-#include <QVBoxLayout>
+#include <QStringList>
 #include <QWidget>
 
-#include <algorithm>
-#include <iterator>
+#include <functional>
 #include <memory>
 #include <vector>
 
 #include "qaccordion_config.hpp"
 
 #include "contentpane.hpp"
+#include "memoryfootprint.hpp"
+#include "slotmap.hpp"
 
 class ContentPane;
+class HeightCache;
+struct QAccordionPrivate;
+
+/**
+ * @brief Description of a content pane for QAccordion::setPanes()
+ *
+ * @details
+ * The \p key identifies a content pane across calls of setPanes(). If it is
+ * empty the \p header is used as key. \p content is an optional factory for
+ * the content frame, it is only used for new content panes and called when
+ * the pane is opened for the first time (see ContentPane::setContentFactory()).
+ */
+struct PaneSpec {
+    QString key;
+    QString header;
+    std::function<QFrame *()> content;
+};
 
 /**
  * @brief QAccordion base class
@@ -50,13 +63,21 @@ class ContentPane;
  * * Use removeContentPane() to remove existing ContentPanes.
  * * moveContentPane() allows you to change the order of the ContentPanes.
  * * To change a ContentPane in place use swapContentPane()
+ * * setPanes() reconciles all ContentPanes with a list of PaneSpec in one batch
+ * * addSection() groups content panes under a section header
+ *
+ * Content panes are addressed by index, header, content frame or pointer.
+ * Indexes change when content panes are inserted, removed or moved. If you need
+ * a long lived reference use getContentPaneHandle() to obtain a PaneHandle.
  *
  * @note
  * Many of the mentioned functions are overloaded, provided for convenience.
  *
  * @details
  * The signal numberOfContentPanesChanged() is emitted whenever the number of
- * content panes changed.
+ * content panes changed. Observers that want to update incrementally should
+ * use the range based signals panesInserted(), panesRemoved(), panesMoved() and
+ * paneActiveChanged() instead.
  *
  * In case of an error you may get a more detailed error description with
  * getError().
@@ -69,11 +90,23 @@ class QAccordion : public QWidget
 {
     Q_OBJECT
 public:
+    /**
+     * @brief Animation policy for opening and closing content panes
+     * @sa
+     * setAnimationPolicy()
+     */
+    enum class ANIMATION {
+        ANIMATED, /**< Always animate */
+        INSTANT,  /**< Never animate, no animation objects are created */
+        AUTO      /**< Animate unless the accordion is large or slow */
+    };
+
     /**
      * @brief QAccordion constructor
      * @param parent Optionally provide a parent widget
      */
     explicit QAccordion(QWidget *parent = nullptr);
+    ~QAccordion() override;
 
     /**
      * @brief Returns the number of content panes
@@ -167,7 +200,8 @@ public:
      * With this method you can replace an existing content pane at \p index with
      * a new one \p cpane.
      *
-     * Returns true if the swap was successfull.
+     * Returns true if the swap was successfull. A __nullptr__ \p cpane is
+     * rejected, the old content pane is kept in this case.
      *
      * The old content pane will be __deleted__.
      */
@@ -218,6 +252,21 @@ public:
      */
     bool removeContentPane(bool deleteObject, ContentPane *contentPane);
 
+    /**
+     * @brief Remove a content pane
+     * @param deleteObject Delete the object and free memory
+     * @param handle Handle of the content pane
+     * @return bool
+     *
+     * @details
+     * This is an overloaded method of removeContentPane(bool, uint). The
+     * handle and the index of the content pane are resolved in O(1)
+     * (amortized, see getContentPaneIndex(PaneHandle)). Removing the pane
+     * itself shifts all content panes behind it and is O(n) in their number.
+     * Returns false if \p handle is stale.
+     */
+    bool removeContentPane(bool deleteObject, PaneHandle handle);
+
     /**
      * @brief Move content pane
      * @param currentIndex The current index of the content pane.
@@ -230,6 +279,125 @@ public:
      */
     bool moveContentPane(uint currentIndex, uint newIndex);
 
+    /**
+     * @brief Insert several content panes
+     * @param index Index of the first new content pane
+     * @param panes Content panes, the accordion takes ownership
+     * @return bool False if \p index is out of range or one of the panes is
+     * already managed by the accordion. No pane is inserted in this case.
+     *
+     * @details
+     * The panes are inserted in one layout operation. panesInserted() and
+     * numberOfContentPanesChanged() are emitted once.
+     */
+    bool insertContentPanes(uint index, const std::vector<ContentPane *> &panes);
+    /**
+     * @brief Remove a range of content panes
+     * @param deleteObject Delete the objects and free memory
+     * @param first Index of the first content pane
+     * @param last Index of the last content pane
+     * @return bool False if the range is invalid
+     *
+     * @details
+     * panesRemoved() and numberOfContentPanesChanged() are emitted once.
+     */
+    bool removeContentPanes(bool deleteObject, uint first, uint last);
+    /**
+     * @brief Move a range of content panes
+     * @param first Index of the first content pane
+     * @param last Index of the last content pane
+     * @param destination Index of the first content pane after the move
+     * @return bool False if the range or \p destination is invalid
+     *
+     * @details
+     * The moved content panes keep their order, open state and handles.
+     * panesMoved() is emitted once.
+     */
+    bool moveContentPanes(uint first, uint last, uint destination);
+
+    /**
+     * @brief Set all content panes at once
+     * @param panes Keyed description of the content panes
+     * @return bool False if a key is used more than once
+     *
+     * @details
+     * Computes the difference between the current content panes and \p panes
+     * and applies it as one batch. Content panes are matched by key, panes
+     * without a key use their header. Matched content panes are kept including
+     * their open state and content frame, only their header is updated. Panes
+     * that are not part of \p panes are deleted and new ones are created.
+     *
+     * The number of moves is minimal, every pane that is part of the longest
+     * increasing subsequence of the current order stays where it is. The range
+     * based signals are emitted for every step, numberOfContentPanesChanged()
+     * is emitted once at the end.
+     */
+    bool setPanes(const std::vector<PaneSpec> &panes);
+
+    /**
+     * @brief Add a section with child content panes
+     * @param header Header of the section, also used as its key
+     * @param panes Child content panes of the section
+     * @return int Index of the section header or -1 on error
+     *
+     * @details
+     * The header and the keys of the children must not contain a slash, it
+     * separates them in a path.
+     *
+     * A section is a content pane without content. Clicking its header expands
+     * or collapses the section. Only the PaneSpec of the children are kept
+     * while the section is collapsed. Their content panes are created when
+     * the section is expanded and inserted right after the section header.
+     * They are deleted again when the section is collapsed.
+     *
+     * The key of a child content pane is its path, the key of the section and
+     * the key of the PaneSpec separated by a slash.
+     */
+    int addSection(QString header, std::vector<PaneSpec> panes);
+    /**
+     * @brief Expand or collapse a section
+     * @param section Key of the section
+     * @param expanded
+     * @return bool False if there is no such section
+     */
+    bool setSectionExpanded(const QString &section, bool expanded);
+    /**
+     * @brief Expand or collapse several sections at once
+     * @param sections Keys of the sections
+     * @param expanded
+     * @return bool False if one of the sections does not exist, nothing is
+     * changed in this case
+     *
+     * @details
+     * Repaints are suspended until all sections are done. panesInserted() or
+     * panesRemoved() is emitted once per section,
+     * numberOfContentPanesChanged() once at the end.
+     */
+    bool setSectionsExpanded(const QStringList &sections, bool expanded);
+    /**
+     * @brief Check if a section is expanded
+     * @param section Key of the section
+     * @return bool False if the section is collapsed or does not exist
+     */
+    bool getSectionExpanded(const QString &section) const;
+    /**
+     * @brief Get the keys of all sections
+     * @return QStringList
+     */
+    QStringList getSections() const;
+    /**
+     * @brief Get a content pane by its path
+     * @param path Key of a top level content pane or section, or
+     * section/child for a child content pane
+     * @return ContentPane* or nullptr
+     *
+     * @details
+     * Child content panes only exist while their section is expanded, expand
+     * it with setSectionExpanded() first. The lookup does not change the
+     * accordion.
+     */
+    ContentPane *getContentPaneByPath(const QString &path);
+
     /**
      * @brief Get content pane
      * @param index Index of the content pane
@@ -241,6 +409,68 @@ public:
      */
     ContentPane *getContentPane(uint index);
 
+    /**
+     * @brief Get content pane
+     * @param handle Handle of the content pane
+     * @return ContentPane* or nullptr
+     *
+     * @details
+     * This is an overloaded method of getContentPane(uint). The handle is
+     * resolved in O(1). A __nullptr__ is returned if \p handle is stale,
+     * meaning the content pane has been removed from the accordion.
+     */
+    ContentPane *getContentPane(PaneHandle handle) const;
+
+    /**
+     * @brief Get a stable handle for a content pane
+     * @param index Index of the content pane
+     * @return PaneHandle, a null handle if \p index is out of range
+     *
+     * @details
+     * The handle stays valid when other content panes are inserted, removed or
+     * moved and may be resolved with getContentPane(PaneHandle) in O(1).
+     */
+    PaneHandle getContentPaneHandle(uint index);
+    /**
+     * @brief Get a stable handle for a content pane
+     * @param contentPane ContentPane*
+     * @return PaneHandle, a null handle if the pane is not managed by this
+     * accordion
+     *
+     * @details
+     * This is an overloaded method of getContentPaneHandle(uint). The lookup
+     * is O(1).
+     */
+    PaneHandle getContentPaneHandle(ContentPane *contentPane) const;
+    /**
+     * @brief Check if a handle refers to a content pane of this accordion
+     * @param handle
+     * @return bool
+     */
+    bool isValidContentPaneHandle(PaneHandle handle) const;
+
+    /**
+     * @brief Get the index of the content pane at vertical position \p y
+     * @param y Position in widget coordinates
+     * @return Index of the content pane or -1
+     *
+     * @details
+     * The lookup is done by the accordion layout in O(log n). The spacing
+     * below a content pane is considered part of it. Use this method for hit
+     * testing or to find the content pane at the top of a scroll area viewport.
+     */
+    int getContentPaneIndexAt(int y) const;
+    /**
+     * @brief Get the vertical position of a content pane
+     * @param index Index of the content pane
+     * @return Top of the content pane in widget coordinates or -1
+     *
+     * @details
+     * This method is O(log n) and may be used to scroll to a content pane.
+     * Positions are updated with the next layout pass.
+     */
+    int getContentPanePosition(uint index);
+
     /**
      * @brief Get the index of a content pane
      * @param header Header of the Content Pane
@@ -269,6 +499,20 @@ public:
      * This is an overloaded function of getContentPaneIndex(QString)
      */
     int getContentPaneIndex(ContentPane *contentPane) const;
+    /**
+     * @brief Get the index of a content pane
+     * @param handle Handle of the content pane
+     * @return Index of the content pane
+     *
+     * @details
+     * This is an overloaded function of getContentPaneIndex(QString). Returns
+     * <b>-1</b> if \p handle is stale.
+     *
+     * Indexes are cached by the layout. The cache is refreshed behind the
+     * first inserted, removed or moved content pane on the next lookup, so
+     * lookups between structural changes are O(1).
+     */
+    int getContentPaneIndex(PaneHandle handle) const;
 
     /**
      * @brief Get the index of the active ContentPane
@@ -286,6 +530,44 @@ public:
      */
     int getNumberOfContentPanes() const;
 
+    /**
+     * @brief Open or close a range of content panes
+     * @param first Index of the first content pane
+     * @param last Index of the last content pane
+     * @param active Open if true, close otherwise
+     * @return bool False if the range is invalid or multiActive forbids it
+     *
+     * @details
+     * All content panes change their state in one transition. With
+     * ANIMATION::ANIMATED a single animation moves all containers, otherwise
+     * the panes are opened or closed instantly with one layout pass at the
+     * end.
+     *
+     * Opening more than one content pane fails unless multiActive is set.
+     * Opening a single pane closes all others if multiActive is false. If
+     * collapsible is false the first open pane of the range stays open when
+     * all others would be closed. paneActiveChanged() is emitted for every
+     * content pane that changes, isActive() and isInactive() of the panes
+     * when the transition finished.
+     */
+    bool setActive(uint first, uint last, bool active);
+    /**
+     * @brief Open all content panes
+     * @return bool
+     *
+     * @sa
+     * setActive()
+     */
+    bool expandAll();
+    /**
+     * @brief Close all content panes
+     * @return bool
+     *
+     * @sa
+     * setActive()
+     */
+    bool collapseAll();
+
     /**
      * @brief Allow multiple ContentPane to be open
      * @param status
@@ -322,6 +604,136 @@ public:
      */
     bool getCollapsible() const;
 
+    /**
+     * @brief Set the animation policy of all content panes
+     * @param policy
+     *
+     * @details
+     * With ANIMATION::INSTANT content panes open and close immediately. No
+     * QPropertyAnimation is created and existing ones are deleted, a toggle
+     * costs a single relayout. This is useful for remote desktop sessions or
+     * users who prefer reduced motion.
+     *
+     * ANIMATION::AUTO animates unless
+     * - the accordion has more than 1000 content panes
+     * - the average frame time of previous animations exceeded 50 ms
+     * - a bulk operation like setPanes() is in progress
+     *
+     * The measured frame time halves every 10 seconds without a new
+     * measurement. A slow frame therefore only switches off animations for a
+     * while, afterwards the next toggle animates again and measures anew.
+     * Setting the policy resets the measured frame time.
+     * @note
+     * Default value for this option is ANIMATION::ANIMATED.
+     */
+    void setAnimationPolicy(ANIMATION policy);
+    /**
+     * @brief Get the animation policy
+     * @return QAccordion::ANIMATION
+     */
+    ANIMATION getAnimationPolicy() const;
+
+    /**
+     * @brief Keep the header of the top content pane visible
+     * @param sticky
+     *
+     * @details
+     * When the accordion is placed inside a QScrollArea and a content pane is
+     * scrolled partly out of the viewport, its header is shown at the top of
+     * the viewport. The accordion does not have to be the widget of the
+     * scroll area, it follows the vertical scroll bar of the closest
+     * enclosing QAbstractScrollArea. The header is painted as a cached image
+     * in an overlay and only grabbed again when the top content pane or the
+     * look of its header changes. Clicks on the overlay go to the real
+     * header.
+     * @note
+     * Default value for this option is \p false.
+     */
+    void setStickyHeaders(bool sticky);
+    /**
+     * @brief Check if sticky headers are enabled
+     * @return bool
+     */
+    bool getStickyHeaders() const;
+
+    /**
+     * @brief Record how often and how recently content panes are opened
+     * @param enable
+     *
+     * @details
+     * Usage is recorded per content pane key, which is the header unless the
+     * pane was created by setPanes() with a key. Opening a single content pane
+     * counts, bulk operations like expandAll() do not.
+     *
+     * While tracking is enabled the accordion uses idle time to build the
+     * content of the content panes that are most likely opened next, see
+     * setPrefetchCount(). Only content panes with a content factory benefit
+     * from this.
+     * @note
+     * Default value for this option is \p false.
+     */
+    void setUsageTracking(bool enable);
+    /**
+     * @brief Check if usage tracking is enabled
+     * @return bool
+     */
+    bool getUsageTracking() const;
+    /**
+     * @brief Set the number of content panes whose content is prefetched
+     * @param count Number of content panes, 0 disables prefetching
+     *
+     * @details
+     * Content panes are ranked by the number of times they were opened divided
+     * by the days since they were opened last plus one. The content factories
+     * of the best \p count content panes are called one per event loop
+     * iteration when there is nothing else to do.
+     * @note
+     * Default value for this option is 3.
+     */
+    void setPrefetchCount(uint count);
+    /**
+     * @brief Get the number of content panes whose content is prefetched
+     * @return uint
+     */
+    uint getPrefetchCount() const;
+    /**
+     * @brief Save the recorded usage statistics
+     * @return QByteArray
+     *
+     * @details
+     * Store the result in your application settings and pass it to
+     * restoreUsageStatistics() at the next start.
+     */
+    QByteArray saveUsageStatistics() const;
+    /**
+     * @brief Restore usage statistics saved with saveUsageStatistics()
+     * @param data
+     * @return bool, false if \p data is invalid. The current statistics are
+     * kept in this case
+     */
+    bool restoreUsageStatistics(const QByteArray &data);
+    /**
+     * @brief Forget all recorded usage statistics
+     */
+    void clearUsageStatistics();
+
+    /**
+     * @brief Use a cache for the heights of content panes with automatic height
+     * @param cache HeightCache, nullptr disables the cache
+     *
+     * @details
+     * The accordion does not take ownership of the \p cache. It must outlive
+     * the accordion or be unset before it is deleted.
+     * @sa
+     * ContentPane::setAutoHeight()
+     */
+    void setHeightCache(HeightCache *cache);
+    /**
+     * @brief Get the height cache
+     * @return HeightCache*, nullptr if there is none
+     */
+    HeightCache *getHeightCache() const;
+
     /**
      * @brief Get error string
      * @return Error string
@@ -332,6 +744,44 @@ public:
      */
     QString getError();
 
+    /**
+     * @brief Set the style of all content pane headers
+     * @param style HeaderStyle
+     *
+     * @details
+     * Other than ContentPane::setHeaderStylesheet() no Qt style sheet is
+     * involved. All headers reference one HeaderStyle object and draw their
+     * background from it, changing the style repaints all content panes in
+     * one pass instead of parsing a style sheet for every header. The style
+     * sheet of the accordion is not touched.
+     *
+     * The default has no background and a slightly lighter background color
+     * on mouse over. Headers that got an own style sheet with
+     * ContentPane::setHeaderStylesheet() or
+     * ContentPane::setHeaderHoverStylesheet() keep it, use
+     * ContentPane::setHeaderSharedStyle() to switch them back.
+     */
+    void setHeaderStyle(const HeaderStyle &style);
+    /**
+     * @brief Get the style of the content pane headers
+     * @return HeaderStyle
+     */
+    HeaderStyle getHeaderStyle() const;
+
+    /**
+     * @brief Estimate the memory used by the accordion and its content panes
+     * @return MemoryFootprint
+     *
+     * @details
+     * Sums up ContentPane::getMemoryFootprint() of all content panes and adds
+     * the bookkeeping of the accordion and its layout to
+     * MemoryFootprint::other and MemoryFootprint::layouts. Pixmaps shared by
+     * several content panes, like the default header icons, are counted once.
+     * Divide the total by getNumberOfContentPanes() to get the cost of a
+     * single pane.
+     */
+    MemoryFootprint getMemoryFootprint() const;
+
 signals:
     /**
      * @brief Signals the new number of content panes
@@ -341,18 +791,52 @@ signals:
      * Signal will be emitted if the number of content panes changes
      */
     void numberOfContentPanesChanged(int number);
+    /**
+     * @brief Content panes have been inserted
+     * @param first Index of the first new content pane
+     * @param last Index of the last new content pane
+     *
+     * @details
+     * Emitted once for a contiguous range of content panes after they have
+     * been inserted.
+     */
+    void panesInserted(int first, int last);
+    /**
+     * @brief Content panes have been removed
+     * @param first Former index of the first removed content pane
+     * @param last Former index of the last removed content pane
+     *
+     * @details
+     * Emitted once for a contiguous range of content panes after they have
+     * been removed.
+     */
+    void panesRemoved(int first, int last);
+    /**
+     * @brief Content panes have been moved
+     * @param sourceFirst Former index of the first moved content pane
+     * @param sourceLast Former index of the last moved content pane
+     * @param destination New index of the first moved content pane
+     *
+     * @details
+     * The moved content panes keep their order. Other than rowsMoved() of
+     * QAbstractItemModel \p destination is the index the first pane has
+     * after the move.
+     */
+    void panesMoved(int sourceFirst, int sourceLast, int destination);
+    /**
+     * @brief A content pane has been opened or closed
+     * @param index Index of the content pane
+     * @param active True if the content pane is now open
+     *
+     * @details
+     * The signal is emitted when the open or close animation starts.
+     */
+    void paneActiveChanged(int index, bool active);
 
 public slots:
 
 private:
-    std::vector<ContentPane *> contentPanes;
-
-    QSpacerItem *spacer;
-
-    QString errorString;
-
-    bool multiActive;
-    bool collapsible;
+    std::unique_ptr<QAccordionPrivate> d;
 
     int internalAddContentPane(QString header, QFrame *cframe = nullptr,
                                ContentPane *cpane = nullptr);
@@ -363,22 +847,111 @@ private:
                                    QString name = "",
                                    QFrame *contentFrame = nullptr,
                                    ContentPane *cpane = nullptr);
+    void attachContentPane(std::size_t index, ContentPane *cpane);
+    void attachContentPanes(std::size_t index,
+                            const std::vector<ContentPane *> &panes);
+    ContentPane *detachContentPane(std::size_t index);
+    std::vector<ContentPane *> detachContentPanes(std::size_t index,
+                                                  std::size_t count);
+    void relocateContentPane(std::size_t currentIndex, std::size_t newIndex);
+    void relocateContentPanes(std::size_t index, std::size_t count,
+                              std::size_t destination);
+    QString contentPaneKey(ContentPane *cpane) const;
     int findContentPaneIndex(QString name = "", QFrame *cframe = nullptr,
                              ContentPane *cpane = nullptr) const;
 
     bool checkIndexError(uint index, bool sizeIndexAllowed,
                          const QString &errMessage);
     void handleClickedSignal(ContentPane *cpane);
+    void setContentPaneActive(int index, bool active);
+    bool animationsEnabled() const;
+    void applyActiveStates(const std::vector<bool> &states);
+    void startBulkTransition(const std::vector<int> &changed,
+                             const std::vector<bool> &states);
+    void stepBulkTransition(double progress);
+    void finishBulkTransition();
+    void updateStickyHeader();
+    void trackScrollArea();
+    void updateFrameTime(ContentPane *cpane);
+    int currentFrameTime() const;
+    void updateHeaderStyle();
+    void updateHoveredHeader(const QPoint &pos);
+    void setHoveredHeader(ClickableFrame *header);
+    void recordUsage(ContentPane *cpane);
+    bool isSection(ContentPane *cpane) const;
+    void expandSection(const QString &key);
+    void collapseSection(const QString &key);
+    void schedulePrefetch();
 
 private slots:
     void numberOfPanesChanged(int number);
+    void prefetchContent();
 
 protected:
+    /**
+     * @brief Create a content pane for addContentPane(), insertContentPane()
+     * and setPanes()
+     * @param header Header of the content pane
+     * @param content Content frame or nullptr
+     * @return ContentPane*
+     *
+     * @details
+     * Reimplement this to let the accordion create instances of your own
+     * ContentPane subclass. QAccordionT does this for you.
+     */
+    virtual ContentPane *createContentPane(QString header, QFrame *content);
+    /**
+     * @brief Reorder the content panes
+     * @param targets Sort key for every content pane, must be unique
+     *
+     * @details
+     * Afterwards the content panes are sorted by \p targets. Only the panes
+     * that are not part of the longest increasing subsequence of \p targets
+     * are moved, panesMoved() is emitted for each of them.
+     */
+    void reorderContentPanes(const std::vector<int> &targets);
+    /**
+     * @brief Track the header under the mouse cursor
+     * @param event
+     *
+     * @details
+     * The accordion is the only widget that receives hover events. The header
+     * under the cursor is looked up with the layout and only the previous and
+     * the new hovered header change their style.
+     */
+    bool event(QEvent *event) override;
+    /**
+     * @brief Update the sticky header when the accordion is scrolled
+     * @param event
+     */
+    void moveEvent(QMoveEvent *event) override;
+    /**
+     * @brief Find the scroll area the sticky header follows
+     * @param event
+     */
+    void showEvent(QShowEvent *event) override;
+    /**
+     * @brief Update the sticky header and the cached background when the
+     * content panes change size
+     * @param event
+     */
+    void resizeEvent(QResizeEvent *event) override;
     /**
      * @brief paintEvent Reimplement paintEvent to use stylesheets in derived Widgets
      * @param event
+     *
+     * @details
+     * The styled background is classified once, only the exposed region is
+     * painted.
+     * @sa
+     * BackgroundCache
+     */
+    void paintEvent(QPaintEvent *event) override;
+    /**
+     * @brief Invalidate the cached background on style and palette changes
+     * @param event
      */
-    void paintEvent(ATTR_UNUSED QPaintEvent *event) override;
+    void changeEvent(QEvent *event) override;
 };
 
 #endif  // QACCORDION_HPP
@@ -0,0 +1,84 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef QACCORDIONDELEGATE_HPP
+#define QACCORDIONDELEGATE_HPP
+
+#include <QFrame>
+#include <QModelIndex>
+#include <QObject>
+
+#include "qaccordion_config.hpp"
+
+#include "contentpane.hpp"
+
+/**
+ * @brief The QAccordionDelegate class
+ *
+ * @details
+ * A QAccordionView uses a delegate to turn the rows of a model into content
+ * panes. The default implementation creates a plain ContentPane, uses
+ * Qt::DisplayRole as header and Qt::ToolTipRole as header tooltip. No content
+ * is created by default.
+ *
+ * Subclass QAccordionDelegate and reimplement createContent() to provide
+ * content for your rows. Content is created lazily, when a content pane is
+ * opened for the first time.
+ */
+class QAccordionDelegate : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief QAccordionDelegate constructor
+     * @param parent Parent object or 0
+     */
+    explicit QAccordionDelegate(QObject *parent = nullptr);
+
+    /**
+     * @brief Create the content pane for a model row
+     * @param index Model index of the row
+     * @return ContentPane*
+     *
+     * @details
+     * Reimplement this method if you want to use your own ContentPane
+     * subclass. The header is set with updateContentPane() afterwards.
+     */
+    virtual ContentPane *createContentPane(const QModelIndex &index) const;
+    /**
+     * @brief Create the content frame for a model row
+     * @param index Model index of the row
+     * @return QFrame* or nullptr
+     *
+     * @details
+     * Called once when the content pane of the row is opened for the first
+     * time. Returning a __nullptr__ keeps the empty content frame.
+     */
+    virtual QFrame *createContent(const QModelIndex &index) const;
+    /**
+     * @brief Update a content pane from the model
+     * @param cpane Content pane of the row
+     * @param index Model index of the row
+     *
+     * @details
+     * Called after a content pane has been created and whenever the data of
+     * the row changed.
+     */
+    virtual void updateContentPane(ContentPane *cpane,
+                                   const QModelIndex &index) const;
+};
+
+#endif  // QACCORDIONDELEGATE_HPP
@@ -0,0 +1,157 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef QACCORDIONT_HPP
+#define QACCORDIONT_HPP
+
+#include <QFrame>
+#include <QString>
+#include <QWidget>
+
+#include <type_traits>
+
+#include "qaccordion_config.hpp"
+
+#include "contentpane.hpp"
+#include "qaccordion.hpp"
+
+/**
+ * @brief QAccordion that manages content panes of type \p PaneT
+ *
+ * @details
+ * If you subclass ContentPane, QAccordion hands out ContentPane pointers that
+ * have to be casted to your type. QAccordionT only accepts \p PaneT content
+ * panes and creates \p PaneT objects in addContentPane(QString),
+ * insertContentPane(uint, QString) and QAccordion::setPanes(). getContentPane()
+ * therefore returns a \p PaneT* with a static_cast, no runtime type check is
+ * involved.
+ *
+ * \p PaneT has to derive from ContentPane and provide the constructor
+ * PaneT(QString header, QFrame *content, QWidget *parent = nullptr). content
+ * may be a __nullptr__, like for ContentPane(QString, QFrame*, QWidget*).
+ *
+ * @code
+ * QAccordionT<MyPane> accordion;
+ * accordion.addContentPane("Pane");
+ * accordion.getContentPane(0)->myMethod();
+ * @endcode
+ *
+ * @warning
+ * Do not add content panes through a QAccordion pointer or reference to a
+ * QAccordionT. Only the methods of QAccordionT make sure every content pane
+ * is a \p PaneT.
+ * @note
+ * Class templates can not have the Q_OBJECT macro, qobject_cast and the meta
+ * object see a QAccordion.
+ */
+template <typename PaneT>
+class QAccordionT : public QAccordion
+{
+    static_assert(std::is_base_of<ContentPane, PaneT>::value,
+                  "PaneT has to derive from ContentPane");
+
+public:
+    /**
+     * @brief QAccordionT constructor
+     * @param parent Optionally provide a parent widget
+     */
+    explicit QAccordionT(QWidget *parent = nullptr) : QAccordion(parent) {}
+
+    /**
+     * @brief Add a new \p PaneT with \p header
+     * @sa QAccordion::addContentPane(QString)
+     */
+    int addContentPane(QString header)
+    {
+        return QAccordion::addContentPane(std::move(header));
+    }
+    /**
+     * @brief Add a new \p PaneT with \p header and \p contentFrame
+     * @sa QAccordion::addContentPane(QString, QFrame*)
+     */
+    int addContentPane(QString header, QFrame *contentFrame)
+    {
+        return QAccordion::addContentPane(std::move(header), contentFrame);
+    }
+    /**
+     * @brief Add content pane
+     * @sa QAccordion::addContentPane(ContentPane*)
+     */
+    int addContentPane(PaneT *cpane)
+    {
+        return QAccordion::addContentPane(cpane);
+    }
+    /**
+     * @brief Insert a new \p PaneT with \p header at \p index
+     * @sa QAccordion::insertContentPane(uint, QString)
+     */
+    bool insertContentPane(uint index, QString header)
+    {
+        return QAccordion::insertContentPane(index, std::move(header));
+    }
+    /**
+     * @brief Insert a new \p PaneT with \p header and \p contentFrame
+     * @sa QAccordion::insertContentPane(uint, QString, QFrame*)
+     */
+    bool insertContentPane(uint index, QString header, QFrame *contentFrame)
+    {
+        return QAccordion::insertContentPane(index, std::move(header),
+                                             contentFrame);
+    }
+    /**
+     * @brief Insert content pane
+     * @sa QAccordion::insertContentPane(uint, ContentPane*)
+     */
+    bool insertContentPane(uint index, PaneT *cpane)
+    {
+        return QAccordion::insertContentPane(index, cpane);
+    }
+    /**
+     * @brief Swap the content pane
+     * @sa QAccordion::swapContentPane()
+     */
+    bool swapContentPane(uint index, PaneT *cpane)
+    {
+        return QAccordion::swapContentPane(index, cpane);
+    }
+
+    /**
+     * @brief Get content pane
+     * @param index Index of the content pane
+     * @return PaneT* or nullptr
+     */
+    PaneT *getContentPane(uint index)
+    {
+        return static_cast<PaneT *>(QAccordion::getContentPane(index));
+    }
+    /**
+     * @brief Get content pane
+     * @param handle Handle of the content pane
+     * @return PaneT* or nullptr if \p handle is stale
+     */
+    PaneT *getContentPane(PaneHandle handle) const
+    {
+        return static_cast<PaneT *>(QAccordion::getContentPane(handle));
+    }
+
+protected:
+    ContentPane *createContentPane(QString header, QFrame *content) override
+    {
+        return new PaneT(std::move(header), content);
+    }
+};
+
+#endif  // QACCORDIONT_HPP
@@ -0,0 +1,143 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef QACCORDIONVIEW_HPP
+#define QACCORDIONVIEW_HPP
+
+#include <QAbstractItemModel>
+#include <QList>
+#include <QModelIndex>
+#include <QPersistentModelIndex>
+#include <QPointer>
+#include <QVector>
+#include <QWidget>
+
+#include <vector>
+
+#include "qaccordion_config.hpp"
+
+#include "qaccordion.hpp"
+#include "qaccordiondelegate.hpp"
+
+/**
+ * @brief Accordion that displays the rows of a QAbstractItemModel
+ *
+ * @details
+ * Every top level row of the model is represented by a ContentPane. The
+ * panes are created by a QAccordionDelegate, by default the header is taken
+ * from Qt::DisplayRole of the model column (see setModelColumn()).
+ *
+ * The view follows the model incrementally. Inserted, removed and moved rows
+ * as well as changed data only touch the affected content panes, every range
+ * of rows is reported by a single QAccordion signal. Layout changes, e.g.
+ * sorting, move the existing content panes with their rows. Content is
+ * created lazily by the delegate when a content pane is opened for the first
+ * time.
+ *
+ * @warning
+ * Do not add, insert, swap, move or remove content panes of a QAccordionView
+ * yourself. Change the model instead.
+ */
+class QAccordionView : public QAccordion
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief QAccordionView constructor
+     * @param parent Optionally provide a parent widget
+     */
+    explicit QAccordionView(QWidget *parent = nullptr);
+
+    /**
+     * @brief Set the model
+     * @param model Model to display or nullptr
+     *
+     * @details
+     * All existing content panes are removed and one content pane for each
+     * top level row of \p model is created. The view does not take ownership
+     * of the model.
+     */
+    void setModel(QAbstractItemModel *model);
+    /**
+     * @brief Get the model
+     * @return QAbstractItemModel* or nullptr
+     */
+    QAbstractItemModel *getModel() const;
+
+    /**
+     * @brief Set the model column used for the content panes
+     * @param column
+     *
+     * @details
+     * Default column is 0.
+     */
+    void setModelColumn(int column);
+    /**
+     * @brief Get the model column
+     * @return int
+     */
+    int getModelColumn() const;
+
+    /**
+     * @brief Set the delegate that creates the content panes
+     * @param delegate QAccordionDelegate* or nullptr for the default delegate
+     *
+     * @details
+     * The view does not take ownership of \p delegate. All content panes are
+     * recreated.
+     */
+    void setDelegate(QAccordionDelegate *delegate);
+    /**
+     * @brief Get the delegate
+     * @return QAccordionDelegate*
+     */
+    QAccordionDelegate *getDelegate() const;
+
+    /**
+     * @brief Get the model index of a content pane
+     * @param index Index of the content pane
+     * @return QModelIndex, invalid if \p index is out of range
+     */
+    QModelIndex getModelIndex(uint index) const;
+
+private:
+    QPointer<QAbstractItemModel> model;
+    QPointer<QAccordionDelegate> delegate;
+    QAccordionDelegate *defaultDelegate;
+
+    int modelColumn;
+    // the rows of the content panes while the model changes its layout
+    std::vector<QPersistentModelIndex> layoutIndexes;
+
+    ContentPane *createContentPaneForRow(int row);
+    void insertRows(int first, int last);
+    void removeRows(int first, int last);
+
+private slots:
+    void modelRowsInserted(const QModelIndex &parent, int first, int last);
+    void modelRowsRemoved(const QModelIndex &parent, int first, int last);
+    void modelRowsMoved(const QModelIndex &parent, int start, int end,
+                        const QModelIndex &destination, int row);
+    void modelDataChanged(const QModelIndex &topLeft,
+                          const QModelIndex &bottomRight,
+                          const QVector<int> &roles);
+    void modelLayoutAboutToBeChanged(
+        const QList<QPersistentModelIndex> &parents);
+    void modelLayoutChanged(const QList<QPersistentModelIndex> &parents);
+    void modelReset();
+};
+
+#endif  // QACCORDIONVIEW_HPP
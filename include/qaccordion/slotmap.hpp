@@ -0,0 +1,177 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SLOTMAP_HPP
+#define SLOTMAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Handle to an element of a SlotMap
+ *
+ * @details
+ * A handle consists of the slot index and the generation of the slot at the
+ * time the element was inserted. Once the element is erased the generation of
+ * the slot changes and the handle is detected as stale. A default constructed
+ * handle is null and never valid.
+ */
+struct SlotHandle {
+    std::uint32_t index = 0;
+    std::uint32_t generation = 0;
+
+    /**
+     * @brief Check if this is a null handle
+     * @return bool
+     */
+    bool isNull() const { return this->generation == 0; }
+
+    bool operator==(const SlotHandle &other) const
+    {
+        return this->index == other.index &&
+               this->generation == other.generation;
+    }
+    bool operator!=(const SlotHandle &other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Generation checked storage with stable handles
+ *
+ * @details
+ * Insert, erase and lookup are O(1). Slots of erased elements are reused, the
+ * generation counter of a slot is incremented every time an element is erased
+ * so old handles can not resolve to a new element.
+ */
+template <typename T>
+class SlotMap
+{
+public:
+    /**
+     * @brief Insert a new element
+     * @param value
+     * @return Handle of the new element
+     */
+    SlotHandle insert(T value)
+    {
+        std::uint32_t index = 0;
+        if (!this->freeSlots.empty()) {
+            index = this->freeSlots.back();
+            this->freeSlots.pop_back();
+        } else {
+            index = static_cast<std::uint32_t>(this->slots.size());
+            this->slots.emplace_back();
+        }
+        Slot &slot = this->slots[index];
+        slot.value = std::move(value);
+        slot.occupied = true;
+        this->count++;
+
+        SlotHandle handle;
+        handle.index = index;
+        handle.generation = slot.generation;
+        return handle;
+    }
+
+    /**
+     * @brief Erase the element \p handle refers to
+     * @param handle
+     * @return bool False if the handle was stale
+     */
+    bool erase(SlotHandle handle)
+    {
+        if (!this->contains(handle)) {
+            return false;
+        }
+        Slot &slot = this->slots[handle.index];
+        slot.value = T();
+        slot.occupied = false;
+        // generation 0 is reserved for null handles
+        if (++slot.generation == 0) {
+            slot.generation = 1;
+        }
+        this->freeSlots.push_back(handle.index);
+        this->count--;
+        return true;
+    }
+
+    /**
+     * @brief Get a pointer to the element \p handle refers to
+     * @param handle
+     * @return Pointer to the element or nullptr if the handle is stale
+     */
+    T *get(SlotHandle handle)
+    {
+        if (!this->contains(handle)) {
+            return nullptr;
+        }
+        return &this->slots[handle.index].value;
+    }
+    const T *get(SlotHandle handle) const
+    {
+        if (!this->contains(handle)) {
+            return nullptr;
+        }
+        return &this->slots[handle.index].value;
+    }
+
+    /**
+     * @brief Check if \p handle refers to an element
+     * @param handle
+     * @return bool
+     */
+    bool contains(SlotHandle handle) const
+    {
+        return !handle.isNull() && handle.index < this->slots.size() &&
+               this->slots[handle.index].occupied &&
+               this->slots[handle.index].generation == handle.generation;
+    }
+
+    /**
+     * @brief Number of elements
+     * @return std::size_t
+     */
+    std::size_t size() const { return this->count; }
+
+    /**
+     * @brief Number of slots, including free ones
+     * @return std::size_t
+     */
+    std::size_t capacity() const { return this->slots.size(); }
+
+    /**
+     * @brief Bytes allocated for the slots and the free list
+     * @return std::size_t
+     */
+    std::size_t memoryUsage() const
+    {
+        return this->slots.capacity() * sizeof(Slot) +
+               this->freeSlots.capacity() * sizeof(std::uint32_t);
+    }
+
+private:
+    struct Slot {
+        T value = T();
+        std::uint32_t generation = 1;
+        bool occupied = false;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<std::uint32_t> freeSlots;
+    std::size_t count = 0;
+};
+
+#endif  // SLOTMAP_HPP
@@ -0,0 +1,80 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef STICKYHEADER_HPP
+#define STICKYHEADER_HPP
+
+#include <QMouseEvent>
+#include <QPaintEvent>
+#include <QPixmap>
+#include <QPointer>
+#include <QWidget>
+
+#include "qaccordion_config.hpp"
+
+#include "clickableframe.hpp"
+
+/**
+ * @brief Overlay that shows the header of the content pane at the top
+ *
+ * @details
+ * Used by QAccordion when sticky headers are enabled. The overlay paints a
+ * cached image of a ClickableFrame instead of moving the real header, the
+ * image is only grabbed again when the header or its size changes or the
+ * header emits ClickableFrame::appearanceChanged(). Mouse clicks are forwarded
+ * to the real header. The class is used internally.
+ */
+class StickyHeader : public QWidget
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief StickyHeader constructor
+     * @param parent Parent widget or 0
+     */
+    explicit StickyHeader(QWidget *parent = nullptr);
+
+    /**
+     * @brief Show \p header in the overlay
+     * @param header
+     */
+    void setHeader(ClickableFrame *header);
+    /**
+     * @brief Get the header the overlay shows
+     * @return ClickableFrame* or nullptr
+     */
+    ClickableFrame *getHeader() const;
+    /**
+     * @brief Grab the header again the next time setHeader() is called
+     */
+    void invalidate();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private:
+    QPointer<ClickableFrame> header;
+    QPixmap pixmap;
+
+    void headerChanged();
+    void grabHeader();
+    void forwardEvent(QMouseEvent *event);
+};
+
+#endif  // STICKYHEADER_HPP
@@ -0,0 +1,391 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "qaccordion/accordionlayout.hpp"
+
+#include <QLayoutItem>
+
+#include <algorithm>
+
+#include "qaccordion/accordiontrace.hpp"
+
+AccordionLayout::AccordionLayout(QWidget *parent)
+    : QLayout(parent),
+      visibleItems(0),
+      dirty(true),
+      fullUpdate(true),
+      requestingWidget(nullptr),
+      updatedItems(0),
+      firstChangedItem(0),
+      firstStaleIndex(0)
+{
+}
+
+AccordionLayout::~AccordionLayout()
+{
+    // deleting the layout items does not delete the widgets
+    for (QLayoutItem *item : this->items) {
+        delete item;
+    }
+    this->items.clear();
+}
+
+void AccordionLayout::insertWidget(int index, QWidget *widget)
+{
+    this->insertWidgets(index, {widget});
+}
+
+void AccordionLayout::insertWidgets(int index,
+                                    const std::vector<QWidget *> &widgets)
+{
+    std::vector<QLayoutItem *> newItems;
+    newItems.reserve(widgets.size());
+    for (QWidget *widget : widgets) {
+        this->addChildWidget(widget);
+        // caches the size hints like the items of QBoxLayout
+        newItems.push_back(new QWidgetItemV2(widget));
+    }
+    if (index < 0 || index > this->count()) {
+        index = this->count();
+    }
+    this->insertItems(static_cast<std::size_t>(index), newItems);
+}
+
+void AccordionLayout::removeWidgets(int index, int count)
+{
+    if (index < 0 || count <= 0 || index + count > this->count()) {
+        return;
+    }
+    auto first = static_cast<std::size_t>(index);
+    auto last = first + static_cast<std::size_t>(count);
+    for (std::size_t i = first; i < last; i++) {
+        QLayoutItem *item = this->items.at(i);
+        this->removeItemSize(this->itemSizes.at(i));
+        if (QWidget *widget = item->widget()) {
+            this->dirtyWidgets.remove(widget);
+            this->widgetIndexes.remove(widget);
+        }
+        delete item;
+    }
+    this->items.erase(this->items.begin() + index,
+                      this->items.begin() + index + count);
+    this->itemSizes.erase(this->itemSizes.begin() + index,
+                          this->itemSizes.begin() + index + count);
+    this->heights.erase(first, last - first);
+    this->minimumHeights.erase(first, last - first);
+    this->structureChanged(first);
+}
+
+void AccordionLayout::insertItem(int index, QLayoutItem *item)
+{
+    if (index < 0 || index > this->count()) {
+        index = this->count();
+    }
+    this->insertItems(static_cast<std::size_t>(index), {item});
+}
+
+void AccordionLayout::insertItems(std::size_t index,
+                                  const std::vector<QLayoutItem *> &newItems)
+{
+    if (newItems.empty()) {
+        return;
+    }
+    this->items.insert(this->items.begin() + index, newItems.begin(),
+                       newItems.end());
+    this->itemSizes.insert(this->itemSizes.begin() + index, newItems.size(),
+                           {-1, 0, 0, 0});
+    this->heights.insert(index, newItems.size(), 0);
+    this->minimumHeights.insert(index, newItems.size(), 0);
+    for (QLayoutItem *item : newItems) {
+        if (QWidget *widget = item->widget()) {
+            this->dirtyWidgets.insert(widget);
+        } else {
+            // spacers and sub layouts do not tell us when they change
+            this->fullUpdate = true;
+        }
+    }
+    this->structureChanged(index);
+}
+
+void AccordionLayout::structureChanged(std::size_t index)
+{
+    this->firstChangedItem = std::min(this->firstChangedItem, index);
+    this->firstStaleIndex = std::min(this->firstStaleIndex, index);
+    this->dirty = true;
+    QLayout::invalidate();
+}
+
+int AccordionLayout::indexAt(int y) const
+{
+    this->updateHeights();
+    int offset = y - this->contentsRect().top();
+    if (offset < 0) {
+        return -1;
+    }
+    // hidden items have a height of 0 and will never be found
+    std::size_t index = this->heights.find(offset);
+    if (index >= this->items.size()) {
+        return -1;
+    }
+    return static_cast<int>(index);
+}
+
+int AccordionLayout::itemPosition(int index) const
+{
+    if (index < 0 || index >= this->count()) {
+        return -1;
+    }
+    this->updateHeights();
+    return this->contentsRect().top() +
+           this->heights.prefixSum(static_cast<std::size_t>(index));
+}
+
+int AccordionLayout::itemHeight(int index) const
+{
+    if (index < 0 || index >= this->count()) {
+        return -1;
+    }
+    this->updateHeights();
+    return std::max(0, this->itemSizes.at(index).height);
+}
+
+void AccordionLayout::addItem(QLayoutItem *item)
+{
+    this->insertItem(-1, item);
+}
+
+int AccordionLayout::count() const
+{
+    return static_cast<int>(this->items.size());
+}
+
+int AccordionLayout::indexOf(QWidget *widget) const
+{
+    // indexes behind a structural change are refreshed on demand, so a batch
+    // of changes costs one pass
+    for (std::size_t i = this->firstStaleIndex; i < this->items.size(); i++) {
+        if (QWidget *w = this->items.at(i)->widget()) {
+            this->widgetIndexes.insert(w, i);
+        }
+    }
+    this->firstStaleIndex = this->items.size();
+    auto it = this->widgetIndexes.constFind(widget);
+    if (it == this->widgetIndexes.constEnd()) {
+        return -1;
+    }
+    return static_cast<int>(it.value());
+}
+
+QLayoutItem *AccordionLayout::itemAt(int index) const
+{
+    if (index < 0 || index >= this->count()) {
+        return nullptr;
+    }
+    return this->items.at(index);
+}
+
+QLayoutItem *AccordionLayout::takeAt(int index)
+{
+    if (index < 0 || index >= this->count()) {
+        return nullptr;
+    }
+    QLayoutItem *item = this->items.at(index);
+    this->items.erase(this->items.begin() + index);
+    this->removeItemSize(this->itemSizes.at(index));
+    this->itemSizes.erase(this->itemSizes.begin() + index);
+    this->heights.erase(static_cast<std::size_t>(index));
+    this->minimumHeights.erase(static_cast<std::size_t>(index));
+    if (QWidget *widget = item->widget()) {
+        this->dirtyWidgets.remove(widget);
+        this->widgetIndexes.remove(widget);
+    }
+    // same as QBoxLayout, a sub layout is no longer our child
+    if (QLayout *l = item->layout()) {
+        if (l->parent() == this) {
+            l->setParent(nullptr);
+        }
+    }
+    this->structureChanged(static_cast<std::size_t>(index));
+    return item;
+}
+
+Qt::Orientations AccordionLayout::expandingDirections() const
+{
+    // the free space at the bottom behaves like the stretch we used to add to
+    // a QVBoxLayout
+    return Qt::Vertical;
+}
+
+QSize AccordionLayout::sizeHint() const
+{
+    this->updateHeights();
+    return this->cachedSizeHint;
+}
+
+QSize AccordionLayout::minimumSize() const
+{
+    this->updateHeights();
+    return this->cachedMinimumSize;
+}
+
+void AccordionLayout::setGeometry(const QRect &rect)
+{
+    QACCORDION_TRACE_SCOPE("AccordionLayout::setGeometry");
+    QLayout::setGeometry(rect);
+    this->updateHeights();
+
+    QRect area = this->contentsRect();
+    std::size_t first = this->firstChangedItem;
+    // everything has to be moved if our own geometry changed
+    if (area != this->lastArea) {
+        first = 0;
+        this->lastArea = area;
+    }
+
+    // items above the first changed one keep their geometry
+    int y = area.top() + this->heights.prefixSum(first);
+    for (std::size_t i = first; i < this->items.size(); i++) {
+        if (this->itemSizes.at(i).height < 0) {
+            continue;
+        }
+        QLayoutItem *item = this->items.at(i);
+        int width = std::min(area.width(), item->maximumSize().width());
+        item->setGeometry(
+            QRect(area.left(), y, width, this->itemSizes.at(i).height));
+        y += this->heights.value(i);
+    }
+    this->firstChangedItem = this->items.size();
+}
+
+void AccordionLayout::invalidate()
+{
+    if (this->requestingWidget != nullptr) {
+        this->dirtyWidgets.insert(this->requestingWidget);
+    } else {
+        // Qt does not tell us which item caused the invalidation
+        this->fullUpdate = true;
+    }
+    this->dirty = true;
+    QLayout::invalidate();
+}
+
+void AccordionLayout::widgetChanged(QWidget *widget)
+{
+    // QLayout::widgetEvent() activates the layout in the LayoutRequest of the
+    // widget, which reaches us as an invalidation of unknown origin. event
+    // filters run after widgetEvent(), they can not attribute it. the layout
+    // is active afterwards, the LayoutRequest does not activate it again.
+    QLayout *layout = widget->layout();
+    if (layout != nullptr && widget->isVisible()) {
+        this->requestingWidget = widget;
+        layout->activate();
+        this->requestingWidget = nullptr;
+    }
+}
+
+int AccordionLayout::getUpdatedItems() const { return this->updatedItems; }
+
+void AccordionLayout::updateHeights() const
+{
+    if (!this->dirty) {
+        return;
+    }
+    QACCORDION_TRACE_SCOPE("AccordionLayout::updateHeights");
+
+    this->updatedItems = 0;
+    if (this->fullUpdate) {
+        for (std::size_t i = 0; i < this->items.size(); i++) {
+            this->updateItem(i);
+        }
+        this->updatedItems = this->count();
+    } else {
+        for (QWidget *widget : this->dirtyWidgets) {
+            int index = this->indexOf(widget);
+            if (index >= 0) {
+                this->updateItem(static_cast<std::size_t>(index));
+                this->updatedItems++;
+            }
+        }
+    }
+    this->dirtyWidgets.clear();
+    this->fullUpdate = false;
+
+    const int space = std::max(0, this->spacing());
+    int hintHeight = this->heights.total();
+    int minHeight = this->minimumHeights.total();
+    if (this->visibleItems > 0) {
+        // no spacing after the last item
+        hintHeight -= space;
+        minHeight -= space;
+    }
+    int hintWidth = this->hintWidths.empty() ? 0 : *this->hintWidths.rbegin();
+    int minWidth =
+        this->minimumWidths.empty() ? 0 : *this->minimumWidths.rbegin();
+    QMargins m = this->contentsMargins();
+    this->cachedSizeHint = QSize(hintWidth + m.left() + m.right(),
+                                 hintHeight + m.top() + m.bottom());
+    this->cachedMinimumSize = QSize(minWidth + m.left() + m.right(),
+                                    minHeight + m.top() + m.bottom());
+    this->dirty = false;
+}
+
+void AccordionLayout::updateItem(std::size_t index) const
+{
+    const int space = std::max(0, this->spacing());
+    QLayoutItem *item = this->items.at(index);
+    ItemSize size = {-1, 0, 0, 0};
+    if (!item->isEmpty()) {
+        QSize hint = item->sizeHint();
+        QSize min = item->minimumSize();
+        QSize max = item->maximumSize();
+        size.height =
+            std::max(min.height(), std::min(hint.height(), max.height()));
+        size.hintWidth = hint.width();
+        size.minimumWidth = min.width();
+        size.minimumHeight = min.height();
+    }
+    int value = size.height < 0 ? 0 : size.height + space;
+    ItemSize &old = this->itemSizes.at(index);
+    if (old.height != size.height || this->heights.value(index) != value) {
+        this->firstChangedItem = std::min(this->firstChangedItem, index);
+    }
+    this->removeItemSize(old);
+    this->addItemSize(size);
+    old = size;
+    this->heights.set(index, value);
+    this->minimumHeights.set(
+        index, size.height < 0 ? 0 : size.minimumHeight + space);
+}
+
+void AccordionLayout::addItemSize(const ItemSize &size) const
+{
+    if (size.height < 0) {
+        return;
+    }
+    this->hintWidths.insert(size.hintWidth);
+    this->minimumWidths.insert(size.minimumWidth);
+    this->visibleItems++;
+}
+
+void AccordionLayout::removeItemSize(const ItemSize &size) const
+{
+    if (size.height < 0) {
+        return;
+    }
+    this->hintWidths.erase(this->hintWidths.find(size.hintWidth));
+    this->minimumWidths.erase(this->minimumWidths.find(size.minimumWidth));
+    this->visibleItems--;
+}
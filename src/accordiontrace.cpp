@@ -0,0 +1,162 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "qaccordion/accordiontrace.hpp"
+
+#ifdef QACCORDION_TRACING
+
+#include <QCoreApplication>
+#include <QFile>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+/*
+ * Every slot carries a sequence number. A writer claims a ticket, marks the
+ * slot as busy (sequence 0), writes the payload and publishes the slot by
+ * storing ticket + 1. A reader only accepts a slot if it sees the same non
+ * zero sequence before and after copying the payload.
+ */
+struct TraceEvent {
+    std::atomic<std::uint64_t> sequence{0};
+    std::atomic<const char *> name{nullptr};
+    std::atomic<std::int64_t> timestamp{0};
+    std::atomic<std::uint32_t> thread{0};
+    std::atomic<char> phase{0};
+};
+
+static TraceEvent traceEvents[AccordionTrace::CAPACITY];
+static std::atomic<std::uint64_t> traceWriteIndex{0};
+static const std::chrono::steady_clock::time_point traceStart =
+    std::chrono::steady_clock::now();
+
+static std::uint32_t traceThreadId()
+{
+    thread_local std::uint32_t id = static_cast<std::uint32_t>(
+        std::hash<std::thread::id>()(std::this_thread::get_id()));
+    return id;
+}
+
+void AccordionTrace::begin(const char *name)
+{
+    AccordionTrace::record(name, 'B');
+}
+
+void AccordionTrace::end(const char *name)
+{
+    AccordionTrace::record(name, 'E');
+}
+
+void AccordionTrace::instant(const char *name)
+{
+    AccordionTrace::record(name, 'i');
+}
+
+void AccordionTrace::clear()
+{
+    for (TraceEvent &event : traceEvents) {
+        event.sequence.store(0, std::memory_order_release);
+    }
+    traceWriteIndex.store(0, std::memory_order_release);
+}
+
+QByteArray AccordionTrace::toChromeTrace()
+{
+    const std::uint64_t written =
+        traceWriteIndex.load(std::memory_order_acquire);
+    const std::uint64_t first = written > CAPACITY ? written - CAPACITY : 0;
+    const QByteArray pid =
+        QByteArray::number(QCoreApplication::applicationPid());
+
+    QByteArray json("{\"traceEvents\":[");
+    bool separator = false;
+    for (std::uint64_t ticket = first; ticket < written; ticket++) {
+        TraceEvent &event = traceEvents[ticket % CAPACITY];
+        std::uint64_t sequence =
+            event.sequence.load(std::memory_order_acquire);
+        if (sequence != ticket + 1) {
+            // slot is being written or has been overwritten already
+            continue;
+        }
+        const char *name = event.name.load(std::memory_order_relaxed);
+        std::int64_t timestamp =
+            event.timestamp.load(std::memory_order_relaxed);
+        std::uint32_t thread = event.thread.load(std::memory_order_relaxed);
+        char phase = event.phase.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (event.sequence.load(std::memory_order_acquire) != sequence) {
+            continue;
+        }
+
+        if (separator) {
+            json.append(',');
+        }
+        separator = true;
+        json.append("{\"name\":\"");
+        json.append(name);
+        json.append("\",\"cat\":\"qaccordion\",\"ph\":\"");
+        json.append(phase);
+        json.append('"');
+        if (phase == 'i') {
+            json.append(",\"s\":\"t\"");
+        }
+        // chrome expects microseconds
+        json.append(",\"ts\":");
+        json.append(QByteArray::number(static_cast<double>(timestamp) / 1000.0,
+                                       'f', 3));
+        json.append(",\"pid\":");
+        json.append(pid);
+        json.append(",\"tid\":");
+        json.append(QByteArray::number(thread));
+        json.append('}');
+    }
+    json.append("],\"displayTimeUnit\":\"ms\"}");
+    return json;
+}
+
+bool AccordionTrace::writeChromeTrace(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    QByteArray json = AccordionTrace::toChromeTrace();
+    return file.write(json) == json.size();
+}
+
+void AccordionTrace::record(const char *name, char phase)
+{
+    const std::int64_t timestamp =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - traceStart)
+            .count();
+    const std::uint64_t ticket =
+        traceWriteIndex.fetch_add(1, std::memory_order_relaxed);
+    TraceEvent &event = traceEvents[ticket % CAPACITY];
+
+    event.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.name.store(name, std::memory_order_relaxed);
+    event.timestamp.store(timestamp, std::memory_order_relaxed);
+    event.thread.store(traceThreadId(), std::memory_order_relaxed);
+    event.phase.store(phase, std::memory_order_relaxed);
+    event.sequence.store(ticket + 1, std::memory_order_release);
+}
+
+#endif  // QACCORDION_TRACING
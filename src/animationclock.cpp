@@ -0,0 +1,43 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "qaccordion/animationclock.hpp"
+
+#include "qaccordion/accordiontrace.hpp"
+
+AnimationClock::AnimationClock(QObject *parent)
+    : QAnimationDriver(parent), time(0)
+{
+}
+
+void AnimationClock::step(qint64 milliseconds)
+{
+    QACCORDION_TRACE_SCOPE("AnimationClock::step");
+    this->time += milliseconds;
+    // animations only advance while Qt has started the driver
+    if (this->isRunning()) {
+        this->advance();
+    }
+}
+
+qint64 AnimationClock::elapsed() const { return this->time; }
+
+void AnimationClock::start()
+{
+    // Qt adds elapsed() to the time the driver has been started
+    this->time = 0;
+    QAnimationDriver::start();
+}
@@ -0,0 +1,138 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "qaccordion/backgroundcache.hpp"
+
+#include <QImage>
+#include <QPainter>
+#include <QStyle>
+#include <QStyleOption>
+
+#include <algorithm>
+
+#include "qaccordion/accordiontrace.hpp"
+
+// rows of the probe image, enough for borders and gradients to show up
+static const int PROBE_HEIGHT = 32;
+
+bool BackgroundCache::enabled = true;
+
+// what QWidget and QStyleSheetStyle would paint without the cache
+static void drawBackground(QWidget *widget, QPainter *p, const QRect &rect)
+{
+    if (widget->autoFillBackground() &&
+        widget->testAttribute(Qt::WA_OpaquePaintEvent)) {
+        // Qt skips auto fill for opaque widgets
+        p->fillRect(rect, widget->palette().brush(widget->backgroundRole()));
+    }
+    QStyleOption o;
+    o.initFrom(widget);
+    o.rect = rect;
+    widget->style()->drawPrimitive(QStyle::PE_Widget, &o, p, widget);
+}
+
+void BackgroundCache::update(QWidget *widget)
+{
+    if (!BackgroundCache::enabled) {
+        this->state = STATE::DIRECT;
+        return;
+    }
+    // solid and transparent backgrounds do not depend on the height
+    if (this->state != STATE::INVALID && this->width == widget->width()) {
+        return;
+    }
+    this->classify(widget);
+    // outside of paint events, Qt reads the flag before it paints
+    widget->setAttribute(Qt::WA_OpaquePaintEvent,
+                         this->state == STATE::SOLID);
+}
+
+void BackgroundCache::paint(QWidget *widget, QPaintEvent *event) const
+{
+    if (this->state == STATE::EMPTY) {
+        return;
+    }
+
+    // Qt clips the painter to the exposed region
+    QPainter p(widget);
+    if (this->state == STATE::SOLID) {
+        p.fillRect(event->rect(), this->color);
+        return;
+    }
+    drawBackground(widget, &p, widget->rect());
+}
+
+void BackgroundCache::invalidate() { this->state = STATE::INVALID; }
+
+void BackgroundCache::setEnabled(bool enabled)
+{
+    BackgroundCache::enabled = enabled;
+}
+
+bool BackgroundCache::getEnabled() { return BackgroundCache::enabled; }
+
+void BackgroundCache::classify(QWidget *widget)
+{
+    QACCORDION_TRACE_SCOPE("BackgroundCache::classify");
+    this->width = widget->width();
+    // without a style sheet or auto fill PE_Widget draws nothing
+    if (!widget->testAttribute(Qt::WA_StyleSheet) &&
+        !widget->autoFillBackground()) {
+        this->state = STATE::EMPTY;
+        return;
+    }
+
+    QRect probeRect(0, 0, std::max(1, this->width),
+                    std::max(1, std::min(widget->height(), PROBE_HEIGHT)));
+    QImage image(probeRect.size(), QImage::Format_ARGB32_Premultiplied);
+    if (image.isNull()) {
+        // we can not tell, keep painting what the style paints
+        this->state = STATE::DIRECT;
+        return;
+    }
+    image.fill(Qt::transparent);
+    {
+        QPainter p(&image);
+        // the probe is painted like an opaque widget, with auto fill
+        if (widget->autoFillBackground()) {
+            p.fillRect(probeRect,
+                       widget->palette().brush(widget->backgroundRole()));
+        }
+        QStyleOption o;
+        o.initFrom(widget);
+        o.rect = probeRect;
+        widget->style()->drawPrimitive(QStyle::PE_Widget, &o, &p, widget);
+    }
+
+    const QRgb first = image.pixel(0, 0);
+    bool uniform = true;
+    for (int y = 0; y < image.height() && uniform; y++) {
+        const auto *line =
+            reinterpret_cast<const QRgb *>(image.constScanLine(y));
+        for (int x = 0; x < image.width() && uniform; x++) {
+            uniform = line[x] == first;
+        }
+    }
+
+    if (uniform && qAlpha(first) == 0) {
+        this->state = STATE::EMPTY;
+    } else if (uniform && qAlpha(first) == 255) {
+        this->state = STATE::SOLID;
+        this->color = QColor::fromRgb(first);
+    } else {
+        this->state = STATE::DIRECT;
+    }
+}
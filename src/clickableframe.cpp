@@ -16,6 +16,11 @@
 
 #include "qaccordion/clickableframe.hpp"
 
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QMouseEvent>
+#include <QPainter>
+
 ClickableFrame::ClickableFrame(QString header, QWidget *parent,
                                Qt::WindowFlags f)
     : iconLabel(nullptr),
@@ -23,8 +28,9 @@ ClickableFrame::ClickableFrame(QString header, QWidget *parent,
       header(std::move(header)),
       QFrame(parent, f)
 {
-    this->setAttribute(Qt::WA_Hover, true);
     this->headerTrigger = TRIGGER::SINGLECLICK;
+    this->sharedStyle = true;
+    this->hovered = false;
     this->setCursor(Qt::PointingHandCursor);
     QColor background = this->palette().color(QPalette::ColorRole::Background);
     QColor lighter = background.lighter(110);
@@ -40,6 +46,10 @@ void ClickableFrame::setTrigger(ClickableFrame::TRIGGER tr)
         this->setCursor(Qt::PointingHandCursor);
     } else {
         this->setCursor(Qt::ForbiddenCursor);
+        // no mouse over effect without trigger
+        if (this->hovered) {
+            this->setHovered(false);
+        }
     }
 }
 
@@ -52,6 +62,7 @@ void ClickableFrame::setHeader(QString header)
 {
     this->header = std::move(header);
     this->nameLabel->setText(this->header);
+    emit this->appearanceChanged();
 }
 
 QString ClickableFrame::getHeader() { return this->header; }
@@ -59,6 +70,7 @@ QString ClickableFrame::getHeader() { return this->header; }
 void ClickableFrame::setIcon(const QPixmap &icon)
 {
     this->iconLabel->setPixmap(icon);
+    emit this->appearanceChanged();
 }
 
 //void ClickableFrame::setIconPosition(ClickableFrame::ICON_POSITION pos) {}
@@ -66,7 +78,8 @@ void ClickableFrame::setIcon(const QPixmap &icon)
 void ClickableFrame::setNormalStylesheet(QString stylesheet)
 {
     this->normalStylesheet = std::move(stylesheet);
-    this->setStyleSheet(this->normalStylesheet);
+    this->sharedStyle = false;
+    this->setHovered(this->hovered);
 }
 
 QString ClickableFrame::getNormalStylesheet() { return this->normalStylesheet; }
@@ -74,27 +87,85 @@ QString ClickableFrame::getNormalStylesheet() { return this->normalStylesheet; }
 void ClickableFrame::setHoverStylesheet(QString stylesheet)
 {
     this->hoverStylesheet = std::move(stylesheet);
+    this->sharedStyle = false;
+    this->setHovered(this->hovered);
 }
 
 QString ClickableFrame::getHoverStylesheet() { return this->hoverStylesheet; }
 
+void ClickableFrame::setSharedStyle(bool shared)
+{
+    if (this->sharedStyle == shared) {
+        return;
+    }
+    this->sharedStyle = shared;
+    if (this->sharedStyle) {
+        this->setStyleSheet("");
+        this->applyTextColor();
+    }
+    this->setHovered(this->hovered);
+}
+
+bool ClickableFrame::getSharedStyle() const { return this->sharedStyle; }
+
+void ClickableFrame::setHeaderStyle(std::shared_ptr<const HeaderStyle> style)
+{
+    this->headerStyle = std::move(style);
+    if (this->sharedStyle) {
+        this->applyTextColor();
+        this->update();
+        emit this->appearanceChanged();
+    }
+}
+
+std::shared_ptr<const HeaderStyle> ClickableFrame::getHeaderStyle() const
+{
+    return this->headerStyle;
+}
+
+void ClickableFrame::setHovered(bool hovered)
+{
+    this->hovered = hovered;
+    if (!this->sharedStyle) {
+        this->setStyleSheet(this->hovered ? this->hoverStylesheet
+                                          : this->normalStylesheet);
+        return;
+    }
+    // paintEvent() picks the background
+    this->update();
+    emit this->appearanceChanged();
+}
+
+void ClickableFrame::applyTextColor()
+{
+    if (this->headerStyle == nullptr ||
+        !this->headerStyle->textColor.isValid() ||
+        this->palette().color(QPalette::WindowText) ==
+            this->headerStyle->textColor) {
+        return;
+    }
+    // the labels inherit the palette
+    QPalette palette = this->palette();
+    palette.setColor(QPalette::WindowText, this->headerStyle->textColor);
+    this->setPalette(palette);
+}
+
 void ClickableFrame::initFrame()
 {
     this->setSizePolicy(QSizePolicy::Policy::Preferred,
                         QSizePolicy::Policy::Fixed);
-    this->setLayout(new QHBoxLayout());
+    auto *layout = new QHBoxLayout();
+    this->setLayout(layout);
 
     this->iconLabel = new QLabel();
     this->iconLabel->setPixmap(QPixmap(this->CARRET_ICON_CLOSED));
-    this->layout()->addWidget(this->iconLabel);
+    layout->addWidget(this->iconLabel);
 
     this->nameLabel = new QLabel();
     nameLabel->setText(this->header);
-    this->layout()->addWidget(nameLabel);
-
-    dynamic_cast<QHBoxLayout *>(this->layout())->addStretch();
+    layout->addWidget(nameLabel);
 
-    this->setStyleSheet(this->normalStylesheet);
+    layout->addStretch();
 }
 
 void ClickableFrame::mousePressEvent(QMouseEvent *event)
@@ -117,17 +188,29 @@ void ClickableFrame::mouseDoubleClickEvent(QMouseEvent *event)
     }
 }
 
-// TODO: No Stylesheet change when TRIGGER::NONE?
-void ClickableFrame::enterEvent(ATTR_UNUSED QEvent *event)
+void ClickableFrame::changeEvent(QEvent *event)
 {
-    if (this->headerTrigger != TRIGGER::NONE) {
-        this->setStyleSheet(this->hoverStylesheet);
+    // style sheets, the palette of the shared style and fonts
+    if (event->type() == QEvent::StyleChange ||
+        event->type() == QEvent::PaletteChange ||
+        event->type() == QEvent::FontChange) {
+        emit this->appearanceChanged();
     }
+    QFrame::changeEvent(event);
 }
 
-void ClickableFrame::leaveEvent(ATTR_UNUSED QEvent *event)
+void ClickableFrame::paintEvent(QPaintEvent *event)
 {
-    if (this->headerTrigger != TRIGGER::NONE) {
-        this->setStyleSheet(this->normalStylesheet);
+    if (this->sharedStyle && this->headerStyle != nullptr) {
+        const QBrush &brush = this->hovered
+                                  ? this->headerStyle->hoverBackground
+                                  : this->headerStyle->background;
+        if (brush.style() != Qt::NoBrush) {
+            // Qt clips to the exposed region, gradients in object bounding
+            // mode need the whole rect
+            QPainter painter(this);
+            painter.fillRect(this->rect(), brush);
+        }
     }
+    QFrame::paintEvent(event);
 }
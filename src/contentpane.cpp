@@ -16,152 +16,498 @@
 
 #include "qaccordion/contentpane.hpp"
 
-ContentPane::ContentPane(QString header, QWidget *parent) : QWidget(parent)
-{
-    this->content = nullptr;
+#include <QAbstractScrollArea>
+#include <QLabel>
+#include <QTimer>
+#include <QVBoxLayout>
+
+#include <algorithm>
+
+#include "contentpane_p.hpp"
+
+#include "qaccordion/accordionlayout.hpp"
+#include "qaccordion/accordiontrace.hpp"
+#include "qaccordion/imageloader.hpp"
+#include "qaccordion/qaccordion.hpp"
 
+ContentPane::ContentPane(QString header, QWidget *parent)
+    : QWidget(parent), d(std::make_unique<ContentPanePrivate>())
+{
     this->initDefaults(std::move(header));
 }
 
 ContentPane::ContentPane(QString header, QFrame *content, QWidget *parent)
-    : content(content), QWidget(parent)
+    : QWidget(parent), d(std::make_unique<ContentPanePrivate>())
 {
+    this->d->content = content;
     this->initDefaults(std::move(header));
 }
 
-bool ContentPane::getActive() const { return this->active; }
+ContentPane::~ContentPane()
+{
+    // the outer pane must not keep the height of this pane, nested panes must
+    // not report to a deleted pane
+    this->detachOuterPane();
+    for (ContentPane *inner : this->d->nestedPanes) {
+        inner->d->reportedTo = nullptr;
+        inner->d->reportedHeight = 0;
+    }
+}
+
+bool ContentPane::getActive() const { return this->d->active; }
 
-QFrame *ContentPane::getContentFrame() { return this->content; }
+QFrame *ContentPane::getContentFrame() { return this->d->content; }
 
 void ContentPane::setContentFrame(QFrame *content)
 {
-    this->container->layout()->removeWidget(this->content);
-    if (this->content != nullptr) {
-        delete (this->content);
+    // explicitly set content wins over a pending factory
+    this->d->contentFactory = nullptr;
+    this->d->preview = QImage();
+    // the content the preview stood in for is not coming back
+    delete (this->d->previewedContent);
+    this->d->previewedContent = nullptr;
+    this->d->containerLayout->removeWidget(this->d->content);
+    if (this->d->content != nullptr) {
+        delete (this->d->content);
+    }
+    this->d->content = content;
+    this->d->containerLayout->insertWidget(0, this->d->content);
+}
+
+void ContentPane::setContentFactory(std::function<QFrame *()> factory)
+{
+    this->d->contentFactory = std::move(factory);
+}
+
+bool ContentPane::hasContentFactory() const
+{
+    return static_cast<bool>(this->d->contentFactory);
+}
+
+void ContentPane::createContent()
+{
+    if (!this->d->contentFactory) {
+        return;
+    }
+    QACCORDION_TRACE_SCOPE("ContentPane::contentFactory");
+    // reset the factory before calling it, it is only used once
+    std::function<QFrame *()> factory = std::move(this->d->contentFactory);
+    this->d->contentFactory = nullptr;
+    QFrame *frame = factory();
+    this->d->preview = QImage();
+    this->d->previewRenderer = nullptr;
+    if (frame != nullptr) {
+        this->setContentFrame(frame);
+    } else if (this->d->previewedContent != nullptr) {
+        // nothing to replace the preview with, show the old content again
+        this->d->containerLayout->removeWidget(this->d->content);
+        delete (this->d->content);
+        this->d->content = this->d->previewedContent;
+        this->d->previewedContent = nullptr;
+        this->d->containerLayout->insertWidget(0, this->d->content);
+        this->d->content->show();
+    }
+    // the preview has been replaced, measure the real content unless an
+    // animation is using the height right now
+    if (this->getActive() &&
+        (!this->d->openAnimation ||
+         this->d->openAnimation->state() != QAbstractAnimation::Running)) {
+        this->verifyHeight();
+    }
+}
+
+void ContentPane::setPreviewRenderer(std::function<QImage(int width)> renderer)
+{
+    this->d->previewRenderer = std::move(renderer);
+    this->d->previewWidth = -1;
+    this->d->preview = QImage();
+    ++this->d->previewRequest;
+    // before the first resize the pane does not know its width yet
+    if (this->testAttribute(Qt::WA_Resized) ||
+        this->testAttribute(Qt::WA_WState_Visible)) {
+        this->renderPreview();
     }
-    this->content = content;
-    dynamic_cast<QVBoxLayout *>(this->container->layout())
-        ->insertWidget(0, this->content);
 }
 
-int ContentPane::getMaximumHeight() { return this->container->maximumHeight(); }
+bool ContentPane::hasPreview() const
+{
+    // a preview of another width would be replaced by content of a different
+    // height
+    return !this->d->preview.isNull() &&
+           this->d->previewWidth == this->width();
+}
+
+void ContentPane::renderPreview()
+{
+    if (!this->d->previewRenderer || !this->d->contentFactory ||
+        this->d->previewWidth == this->width()) {
+        return;
+    }
+    this->d->preview = QImage();
+    int request = ++this->d->previewRequest;
+    int width = this->width();
+    this->d->previewWidth = width;
+    std::function<QImage(int width)> renderer = this->d->previewRenderer;
+    ImageLoader::instance()->render(
+        [renderer, width]() { return renderer(width); }, this,
+        [this, request](const QImage &image) {
+            // the preview is useless once the content has been built
+            if (request != this->d->previewRequest || !this->d->contentFactory) {
+                return;
+            }
+            this->d->preview = image;
+        });
+}
+
+void ContentPane::showPreview()
+{
+    QACCORDION_TRACE_SCOPE("ContentPane::showPreview");
+    auto *frame = new QFrame();
+    frame->setLayout(new QVBoxLayout());
+    frame->layout()->setContentsMargins(0, 0, 0, 0);
+    auto *label = new QLabel();
+    label->setAlignment(Qt::AlignLeft | Qt::AlignTop);
+    label->setPixmap(QPixmap::fromImage(this->d->preview));
+    frame->layout()->addWidget(label);
+
+    // keep the current content, the factory may still return a nullptr
+    this->d->containerLayout->removeWidget(this->d->content);
+    if (this->d->content != nullptr) {
+        this->d->content->hide();
+    }
+    delete (this->d->previewedContent);
+    this->d->previewedContent = this->d->content;
+    this->d->content = frame;
+    this->d->containerLayout->insertWidget(0, this->d->content);
+    // posted paint events are delivered before timers, the preview is on
+    // screen before the content is built
+    QTimer::singleShot(0, this, [this]() { this->createContent(); });
+}
+
+int ContentPane::getMaximumHeight()
+{
+    return this->d->container->maximumHeight();
+}
 
 void ContentPane::setMaximumHeight(int maxHeight)
 {
-    this->containerAnimationMaxHeight = maxHeight;
+    this->d->autoHeight = false;
+    this->applyMaximumHeight(maxHeight);
+}
+
+void ContentPane::setAutoHeight(bool autoHeight)
+{
+    this->d->autoHeight = autoHeight;
+    this->d->heightVerified = false;
+    if (this->d->autoHeight && this->getActive()) {
+        this->updateAutoHeight();
+    }
+}
+
+bool ContentPane::getAutoHeight() const { return this->d->autoHeight; }
+
+void ContentPane::setContentType(QString contentType)
+{
+    this->d->contentType = std::move(contentType);
+}
+
+QString ContentPane::getContentType() const { return this->d->contentType; }
+
+void ContentPane::applyMaximumHeight(int maxHeight)
+{
+    this->d->containerAnimationMaxHeight = maxHeight;
+    this->applyOpenHeight();
+}
+
+void ContentPane::applyMeasuredHeight(int height)
+{
+    // the layout was measured with the nested panes as they are now
+    this->d->nestedHeight = 0;
+    this->d->nestedDelta = 0;
+    this->applyMaximumHeight(height);
+}
+
+int ContentPane::getOpenHeight() const
+{
+    return std::max(this->d->containerAnimationMaxHeight +
+                        this->d->nestedHeight,
+                    0);
+}
 
+void ContentPane::applyOpenHeight()
+{
+    int height = this->getOpenHeight();
+    if (this->d->openAnimation) {
+        this->d->openAnimation->setEndValue(height);
+        this->d->closeAnimation->setStartValue(height);
+        // a running open animation heads for the new height instead of
+        // jumping there
+        if (this->d->openAnimation->state() == QAbstractAnimation::Running) {
+            return;
+        }
+    }
     if (this->getActive()) {
-        this->container->setMaximumHeight(this->containerAnimationMaxHeight);
+        this->setContainerHeight(height);
     }
-    this->openAnimation->setEndValue(this->containerAnimationMaxHeight);
-    this->closeAnimation->setStartValue(this->containerAnimationMaxHeight);
+}
+
+void ContentPane::setContentHeight(int height)
+{
+    QMargins margins = this->d->containerLayout->contentsMargins();
+    this->d->autoHeight = false;
+    this->applyMaximumHeight(height + 2 * this->d->container->frameWidth() +
+                             margins.top() + margins.bottom());
 }
 
 void ContentPane::setTrigger(ClickableFrame::TRIGGER tr)
 {
-    this->header->setTrigger(tr);
+    this->d->header->setTrigger(tr);
 }
 
 ClickableFrame::TRIGGER ContentPane::getTrigger()
 {
-    return this->header->getTrigger();
+    return this->d->header->getTrigger();
 }
 
 void ContentPane::setHeader(QString header)
 {
-    this->header->setHeader(std::move(header));
+    this->d->header->setHeader(std::move(header));
 }
 
-QString ContentPane::getHeader() { return this->header->getHeader(); }
+QString ContentPane::getHeader() { return this->d->header->getHeader(); }
 
 void ContentPane::setHeaderIconActive(const QString &icon)
 {
+    this->d->pendingIconActive.clear();
     QPixmap pic(icon);
     if (!pic.isNull()) {
-        this->headerIconActive = pic;
+        this->d->headerIconActive = pic;
         if (this->getActive()) {
-            this->header->setIcon(this->headerIconActive);
+            this->d->header->setIcon(this->d->headerIconActive);
         }
     }
 }
 
 void ContentPane::setHeaderIconActive(const QPixmap &icon)
 {
+    this->d->pendingIconActive.clear();
     if (!icon.isNull()) {
-        this->headerIconActive = icon;
+        this->d->headerIconActive = icon;
         if (this->getActive()) {
-            this->header->setIcon(this->headerIconActive);
+            this->d->header->setIcon(this->d->headerIconActive);
         }
     }
 }
 
-QPixmap ContentPane::getHeaderIconActive() { return this->headerIconActive; }
+QPixmap ContentPane::getHeaderIconActive() { return this->d->headerIconActive; }
+
+void ContentPane::setHeaderIconActiveAsync(const QString &icon)
+{
+    this->d->pendingIconActive = icon;
+    ImageLoader::instance()->load(
+        icon, this, [this, icon](const QPixmap &pixmap) {
+            // another icon has been set in the meantime
+            if (this->d->pendingIconActive != icon) {
+                return;
+            }
+            this->setHeaderIconActive(pixmap);
+            this->d->pendingIconActive.clear();
+        });
+}
 
 void ContentPane::setHeaderIconInActive(const QString &icon)
 {
+    this->d->pendingIconInActive.clear();
     QPixmap pic(icon);
     if (!pic.isNull()) {
-        this->headerIconInActive = pic;
+        this->d->headerIconInActive = pic;
         if (!this->getActive()) {
-            this->header->setIcon(this->headerIconInActive);
+            this->d->header->setIcon(this->d->headerIconInActive);
         }
     }
 }
 
 void ContentPane::setHeaderIconInActive(const QPixmap &icon)
 {
+    this->d->pendingIconInActive.clear();
     if (!icon.isNull()) {
-        this->headerIconInActive = icon;
+        this->d->headerIconInActive = icon;
         if (!this->getActive()) {
-            this->header->setIcon(this->headerIconInActive);
+            this->d->header->setIcon(this->d->headerIconInActive);
         }
     }
 }
 
-QPixmap ContentPane::getHeaderIconInActive() { return this->headerIconInActive; }
+QPixmap ContentPane::getHeaderIconInActive()
+{
+    return this->d->headerIconInActive;
+}
+
+void ContentPane::setHeaderIconInActiveAsync(const QString &icon)
+{
+    this->d->pendingIconInActive = icon;
+    ImageLoader::instance()->load(
+        icon, this, [this, icon](const QPixmap &pixmap) {
+            // another icon has been set in the meantime
+            if (this->d->pendingIconInActive != icon) {
+                return;
+            }
+            this->setHeaderIconInActive(pixmap);
+            this->d->pendingIconInActive.clear();
+        });
+}
 
 void ContentPane::setHeaderTooltip(const QString &tooltip)
 {
-    this->header->setToolTip(tooltip);
+    this->d->header->setToolTip(tooltip);
 }
 
-QString ContentPane::getHeaderTooltip() { return this->header->toolTip(); }
+QString ContentPane::getHeaderTooltip() { return this->d->header->toolTip(); }
 
 void ContentPane::setHeaderStylesheet(QString stylesheet)
 {
-    this->header->setNormalStylesheet(std::move(stylesheet));
+    this->d->header->setNormalStylesheet(std::move(stylesheet));
 }
 
 QString ContentPane::getHeaderStylesheet()
 {
-    return this->header->getNormalStylesheet();
+    return this->d->header->getNormalStylesheet();
 }
 
 void ContentPane::setHeaderHoverStylesheet(QString stylesheet)
 {
-    this->header->setHoverStylesheet(std::move(stylesheet));
+    this->d->header->setHoverStylesheet(std::move(stylesheet));
 }
 
 QString ContentPane::getHeaderHoverStylesheet()
 {
-    return this->header->getHoverStylesheet();
+    return this->d->header->getHoverStylesheet();
+}
+
+void ContentPane::setHeaderSharedStyle(bool shared)
+{
+    this->d->header->setSharedStyle(shared);
+}
+
+bool ContentPane::getHeaderSharedStyle() const
+{
+    return this->d->header->getSharedStyle();
 }
 
 void ContentPane::setHeaderFrameStyle(int style)
 {
-    this->header->setFrameStyle(style);
+    this->d->header->setFrameStyle(style);
 }
 
-int ContentPane::getHeaderFrameStyle() { return this->header->frameStyle(); }
+int ContentPane::getHeaderFrameStyle() { return this->d->header->frameStyle(); }
 
 void ContentPane::setContainerFrameStyle(int style)
 {
-    this->container->setFrameStyle(style);
+    this->d->container->setFrameStyle(style);
 }
 
 int ContentPane::getContainerFrameStyle()
 {
-    return this->container->frameStyle();
+    return this->d->container->frameStyle();
+}
+
+void ContentPane::setAnimationDuration(uint duration)
+{
+    this->d->animationDuration = duration;
+    if (this->d->openAnimation) {
+        this->d->openAnimation->setDuration(static_cast<int>(duration));
+        this->d->closeAnimation->setDuration(static_cast<int>(duration));
+    }
+}
+
+uint ContentPane::getAnimationDuration() { return this->d->animationDuration; }
+
+MemoryFootprint ContentPane::getMemoryFootprint() const
+{
+    MemoryFootprint footprint;
+    QSet<qint64> pixmapKeys;
+    this->addMemoryFootprint(footprint, pixmapKeys);
+    return footprint;
+}
+
+void ContentPane::addMemoryFootprint(MemoryFootprint &footprint,
+                                     QSet<qint64> &pixmapKeys) const
+{
+    // the pane itself, members like the content factory are part of it
+    footprint.widgets += MemoryFootprint::estimateObject(this) +
+                         sizeof(ContentPane) - sizeof(QWidget) +
+                         sizeof(ContentPanePrivate);
+    footprint.strings += MemoryFootprint::estimateString(this->d->key);
+    footprint.strings +=
+        MemoryFootprint::estimateString(this->d->header->getHeader()) +
+        MemoryFootprint::estimateString(this->d->header->getNormalStylesheet()) +
+        MemoryFootprint::estimateString(this->d->header->getHoverStylesheet());
+    footprint.pixmaps +=
+        MemoryFootprint::estimatePixmap(this->d->headerIconActive, pixmapKeys) +
+        MemoryFootprint::estimatePixmap(this->d->headerIconInActive,
+                                        pixmapKeys);
+    // a preview that has not been shown yet
+    footprint.content +=
+        static_cast<std::size_t>(this->d->preview.bytesPerLine()) *
+        static_cast<std::size_t>(this->d->preview.height());
+
+    for (const QObject *object : this->findChildren<QObject *>()) {
+        std::size_t size = MemoryFootprint::estimateObject(object);
+        std::size_t strings = 0;
+        std::size_t pixmaps = 0;
+        if (object->isWidgetType()) {
+            const auto *widget = static_cast<const QWidget *>(object);
+            strings += MemoryFootprint::estimateString(widget->toolTip()) +
+                       MemoryFootprint::estimateString(widget->styleSheet());
+        }
+        if (const auto *label = qobject_cast<const QLabel *>(object)) {
+            // label texts share their data with the header string
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+            QPixmap pixmap = label->pixmap(Qt::ReturnByValue);
+            if (!pixmap.isNull()) {
+                pixmaps += MemoryFootprint::estimatePixmap(pixmap, pixmapKeys);
+            }
+#else
+            const QPixmap *pixmap = label->pixmap();
+            if (pixmap != nullptr) {
+                pixmaps += MemoryFootprint::estimatePixmap(*pixmap, pixmapKeys);
+            }
+#endif
+        }
+
+        if (this->isContentObject(object)) {
+            footprint.content += size + strings + pixmaps;
+            continue;
+        }
+        if (object->isWidgetType()) {
+            footprint.widgets += size;
+        } else if (qobject_cast<const QLayout *>(object) != nullptr) {
+            footprint.layouts += size;
+        } else {
+            footprint.other += size;
+        }
+        footprint.strings += strings;
+        footprint.pixmaps += pixmaps;
+    }
+
+    // the animations are no children of the pane
+    footprint.animations +=
+        MemoryFootprint::estimateObject(this->d->openAnimation.get()) +
+        MemoryFootprint::estimateObject(this->d->closeAnimation.get());
+}
+
+bool ContentPane::isContentObject(const QObject *object) const
+{
+    if (this->d->content == nullptr) {
+        return false;
+    }
+    for (; object != nullptr && object != this; object = object->parent()) {
+        if (object == this->d->content ||
+            object == this->d->previewedContent) {
+            return true;
+        }
+    }
+    return false;
 }
 
 void ContentPane::openContentPane()
@@ -169,9 +515,15 @@ void ContentPane::openContentPane()
     if (this->getActive()) {
         return;
     }
-    this->openAnimation->start();
-    this->header->setIcon(this->headerIconActive);
-    this->active = true;
+    this->setActiveState(true);
+    if (!this->d->animated) {
+        this->setContainerHeight(this->getOpenHeight());
+        this->emitActiveState();
+        return;
+    }
+    this->initAnimations();
+    this->d->animationFrames = 0;
+    this->d->openAnimation->start();
 }
 
 void ContentPane::closeContentPane()
@@ -179,19 +531,290 @@ void ContentPane::closeContentPane()
     if (!this->getActive()) {
         return;
     }
-    this->closeAnimation->start();
-    this->header->setIcon(this->headerIconInActive);
-    this->active = false;
+    this->setActiveState(false);
+    if (!this->d->animated) {
+        this->setContainerHeight(0);
+        this->emitActiveState();
+        return;
+    }
+    this->initAnimations();
+    this->d->animationFrames = 0;
+    this->d->closeAnimation->start();
 }
 
-void ContentPane::initDefaults(QString header)
+void ContentPane::setActiveState(bool active)
+{
+    this->d->active = active;
+    this->d->frameTime = -1;
+    if (this->d->active) {
+        if (this->d->contentFactory && this->applyCachedHeight()) {
+            // the animation runs to the cached height right away. the content
+            // is built after the first frame and verified once it is open.
+            if (this->hasPreview()) {
+                this->showPreview();
+            } else {
+                QTimer::singleShot(0, this,
+                                   [this]() { this->createContent(); });
+            }
+        } else {
+            if (this->hasPreview() && this->d->contentFactory) {
+                this->showPreview();
+            } else {
+                this->createContent();
+            }
+            this->updateAutoHeight();
+        }
+        this->d->header->setIcon(this->d->headerIconActive);
+    } else {
+        this->d->header->setIcon(this->d->headerIconInActive);
+    }
+    // a running animation must not fight with the new state
+    if (this->d->openAnimation) {
+        this->d->openAnimation->stop();
+        this->d->closeAnimation->stop();
+    }
+    if (this->d->active) {
+        emit this->aboutToOpen();
+    }
+}
+
+void ContentPane::emitActiveState()
+{
+    if (this->d->active) {
+        this->verifyHeight();
+        emit this->isActive();
+    } else {
+        emit this->isInactive();
+    }
+}
+
+void ContentPane::setAnimated(bool animated)
+{
+    this->d->animated = animated;
+}
+
+void ContentPane::releaseAnimations()
+{
+    this->d->openAnimation.reset();
+    this->d->closeAnimation.reset();
+}
+
+QString ContentPane::heightKey()
+{
+    return HeightCache::makeKey(
+        this->d->key.isEmpty() ? this->getHeader() : this->d->key,
+        this->d->contentType,
+#if QT_VERSION >= QT_VERSION_CHECK(5, 6, 0)
+        this->width(), this->font(), this->devicePixelRatioF());
+#else
+        this->width(), this->font(), this->devicePixelRatio());
+#endif
+}
+
+int ContentPane::measureHeight() const
 {
-    this->active = false;
+    QACCORDION_TRACE_SCOPE("ContentPane::measureHeight");
+    QLayout *layout = this->d->containerLayout;
+    if (layout->hasHeightForWidth() && this->d->container->width() > 0) {
+        return layout->totalHeightForWidth(this->d->container->width());
+    }
+    return layout->totalSizeHint().height();
+}
+
+bool ContentPane::applyCachedHeight()
+{
+    if (!this->d->autoHeight || this->d->heightCache == nullptr ||
+        this->d->heightVerified) {
+        return false;
+    }
+    int height = this->d->heightCache->lookup(this->heightKey());
+    if (height < 0) {
+        return false;
+    }
+    this->applyMeasuredHeight(height);
+    this->d->heightPending = true;
+    return true;
+}
+
+void ContentPane::updateAutoHeight()
+{
+    if (!this->d->autoHeight || this->applyCachedHeight()) {
+        return;
+    }
+    int height = this->measureHeight();
+    this->applyMeasuredHeight(height);
+    if (this->d->contentFactory) {
+        // a preview is measured again once the content has been built
+        this->d->heightPending = true;
+        return;
+    }
+    this->d->heightPending = false;
+    this->d->heightVerified = true;
+    if (this->d->heightCache != nullptr) {
+        this->d->heightCache->insert(this->heightKey(), height);
+    }
+}
+
+void ContentPane::verifyHeight()
+{
+    if (!this->d->autoHeight || !this->d->heightPending ||
+        this->d->contentFactory) {
+        return;
+    }
+    this->d->heightPending = false;
+    this->d->heightVerified = true;
+    int height = this->measureHeight();
+    if (height != this->getOpenHeight()) {
+        this->applyMeasuredHeight(height);
+    }
+    if (this->d->heightCache != nullptr) {
+        this->d->heightCache->insert(this->heightKey(), height);
+    }
+}
+
+int ContentPane::getFrameTime() const { return this->d->frameTime; }
+
+void ContentPane::setContainerHeight(int height)
+{
+    this->d->container->setMaximumHeight(height);
+    this->containerHeightChanged();
+}
 
-    this->headerFrameStyle = QFrame::Shape::StyledPanel | QFrame::Shadow::Raised;
-    this->contentPaneFrameStyle =
+void ContentPane::containerHeightChanged()
+{
+    // the accordion only measures this pane again
+    QWidget *parent = this->parentWidget();
+    if (auto *layout = qobject_cast<AccordionLayout *>(
+            parent != nullptr ? parent->layout() : nullptr)) {
+        layout->widgetChanged(this);
+    }
+
+    ContentPane *outer = this->getOuterPane();
+    if (outer != this->d->reportedTo) {
+        // the pane moved, the old outer pane loses its height
+        this->detachOuterPane();
+        if (outer == nullptr) {
+            return;
+        }
+        this->d->reportedTo = outer;
+        outer->d->nestedPanes.insert(this);
+    } else if (outer == nullptr) {
+        return;
+    }
+    int delta = this->d->container->maximumHeight() - this->d->reportedHeight;
+    if (delta == 0) {
+        return;
+    }
+    this->d->reportedHeight += delta;
+    // while this frame is applied already there is no need to wait for the
+    // next iteration at every level
+    outer->nestedHeightChanged(delta, this->d->applyingNested);
+}
+
+void ContentPane::detachOuterPane()
+{
+    ContentPane *outer = this->d->reportedTo;
+    if (outer == nullptr) {
+        return;
+    }
+    outer->d->nestedPanes.remove(this);
+    this->d->reportedTo = nullptr;
+    int delta = -this->d->reportedHeight;
+    this->d->reportedHeight = 0;
+    if (delta != 0) {
+        outer->nestedHeightChanged(delta, false);
+    }
+}
+
+ContentPane *ContentPane::getOuterPane() const
+{
+    // a pane that was removed from its accordion is not laid out any more
+    if (this->d->handle.isNull() &&
+        qobject_cast<QAccordion *>(this->parentWidget()) != nullptr) {
+        return nullptr;
+    }
+    for (QWidget *w = this->parentWidget(); w != nullptr && !w->isWindow();
+         w = w->parentWidget()) {
+        if (qobject_cast<QAbstractScrollArea *>(w) != nullptr) {
+            return nullptr;
+        }
+        auto *pane = qobject_cast<ContentPane *>(w);
+        if (pane != nullptr) {
+            return pane;
+        }
+    }
+    return nullptr;
+}
+
+void ContentPane::nestedHeightChanged(int delta, bool now)
+{
+    this->d->nestedDelta += delta;
+    if (now) {
+        this->updateNestedHeight();
+    } else if (!this->d->nestedUpdatePending) {
+        this->d->nestedUpdatePending = true;
+        QTimer::singleShot(0, this, [this]() {
+            if (this->d->nestedUpdatePending) {
+                this->updateNestedHeight();
+            }
+        });
+    }
+}
+
+void ContentPane::updateNestedHeight()
+{
+    this->d->nestedUpdatePending = false;
+    int delta = this->d->nestedDelta;
+    this->d->nestedDelta = 0;
+    // opening one inner pane while closing another one may cancel out
+    if (delta == 0) {
+        return;
+    }
+    QACCORDION_TRACE_SCOPE("ContentPane::updateNestedHeight");
+    this->d->applyingNested = true;
+    // the height set by the user or measured from the content is kept
+    this->d->nestedHeight += delta;
+    this->applyOpenHeight();
+    this->d->applyingNested = false;
+}
+
+void ContentPane::animationFinished()
+{
+    // the animation time is the time of the animation driver, wall clock or
+    // AnimationClock, so a stepped clock reports the frames it stepped
+    QPropertyAnimation *animation = this->d->active
+                                        ? this->d->openAnimation.get()
+                                        : this->d->closeAnimation.get();
+    if (this->d->animationFrames > 0) {
+        this->d->frameTime = animation->duration() / this->d->animationFrames;
+    }
+    this->emitActiveState();
+}
+
+void ContentPane::initDefaults(QString header)
+{
+    this->d->active = false;
+    this->d->animated = true;
+    this->d->animationDuration = 300;
+    this->d->animationFrames = 0;
+    this->d->frameTime = -1;
+    this->d->previewRequest = 0;
+    this->d->previewWidth = -1;
+    this->d->reportedHeight = 0;
+    this->d->nestedHeight = 0;
+    this->d->nestedDelta = 0;
+    this->d->nestedUpdatePending = false;
+    this->d->applyingNested = false;
+
+    this->d->headerFrameStyle =
+        QFrame::Shape::StyledPanel | QFrame::Shadow::Raised;
+    this->d->contentPaneFrameStyle =
         QFrame::Shape::StyledPanel | QFrame::Shadow::Plain;
-    this->containerAnimationMaxHeight = 150;
+    this->d->containerAnimationMaxHeight = 150;
+    this->d->autoHeight = false;
+    this->d->heightPending = false;
+    this->d->heightVerified = false;
+    this->d->heightCache = nullptr;
     // TODO: Why do I need to set the vertial policy to Maximum? from the api
     // documentation Minimum would make more sens :/
     this->setSizePolicy(QSizePolicy::Policy::Preferred,
@@ -203,65 +826,92 @@ void ContentPane::initDefaults(QString header)
 
     this->initHeaderFrame(std::move(header));
     this->initContainerContentFrame();
-    this->initAnimations();
+    // animations are created when they are needed for the first time
 }
 
 void ContentPane::initHeaderFrame(QString header)
 {
-    this->header = new ClickableFrame(std::move(header));
-    this->header->setFrameStyle(this->headerFrameStyle);
+    this->d->header = new ClickableFrame(std::move(header));
+    this->d->header->setFrameStyle(this->d->headerFrameStyle);
     // init the icons
-    this->setHeaderIconActive(this->header->CARRET_ICON_OPENED);
-    this->setHeaderIconInActive(this->header->CARRET_ICON_CLOSED);
-    this->layout()->addWidget(this->header);
+    this->setHeaderIconActive(this->d->header->CARRET_ICON_OPENED);
+    this->setHeaderIconInActive(this->d->header->CARRET_ICON_CLOSED);
+    this->layout()->addWidget(this->d->header);
 
-    QObject::connect(this->header, &ClickableFrame::triggered, this,
+    QObject::connect(this->d->header, &ClickableFrame::triggered, this,
                      &ContentPane::headerTriggered);
 }
 
 void ContentPane::initContainerContentFrame()
 {
-    this->container = new QFrame();
-    this->container->setLayout(new QVBoxLayout());
-    this->container->setFrameStyle(this->contentPaneFrameStyle);
-    this->container->setMaximumHeight(0);
-    this->container->setSizePolicy(QSizePolicy::Policy::Preferred,
-                                   QSizePolicy::Policy::Preferred);
-    this->layout()->addWidget(this->container);
-
-    if (this->content == nullptr) {
-        this->content = new QFrame();
+    this->d->container = new QFrame();
+    this->d->containerLayout = new QVBoxLayout();
+    this->d->container->setLayout(this->d->containerLayout);
+    this->d->container->setFrameStyle(this->d->contentPaneFrameStyle);
+    this->d->container->setMaximumHeight(0);
+    this->d->container->setSizePolicy(QSizePolicy::Policy::Preferred,
+                                      QSizePolicy::Policy::Preferred);
+    this->layout()->addWidget(this->d->container);
+
+    if (this->d->content == nullptr) {
+        this->d->content = new QFrame();
     }
 
-    this->container->layout()->addWidget(this->content);
-    this->container->layout()->setSpacing(0);
-    this->container->layout()->setContentsMargins(QMargins());
+    this->d->containerLayout->addWidget(this->d->content);
+    this->d->containerLayout->setSpacing(0);
+    this->d->containerLayout->setContentsMargins(QMargins());
 }
 
 void ContentPane::initAnimations()
 {
-    this->openAnimation = std::make_unique<QPropertyAnimation>();
-    this->closeAnimation = std::make_unique<QPropertyAnimation>();
+    if (this->d->openAnimation) {
+        return;
+    }
+    QACCORDION_TRACE_SCOPE("ContentPane::initAnimations");
+    this->d->openAnimation = std::make_unique<QPropertyAnimation>();
+    this->d->closeAnimation = std::make_unique<QPropertyAnimation>();
     // TODO: Currently these animations only animate maximumHeight. This leads to
     // different behaviour depending on whether the Accordion Widget is placed
     // inside a QScollWidget or not. Maybe we also need to animate minimumHeight
     // as well to get the same effect.
     // TODO: Lots of boilerplate code here
-    this->openAnimation->setTargetObject(this->container);
-    this->openAnimation->setPropertyName("maximumHeight");
-    this->closeAnimation->setTargetObject(this->container);
-    this->closeAnimation->setPropertyName("maximumHeight");
-
-    this->openAnimation->setDuration(300);
-    this->closeAnimation->setDuration(300);
-    this->openAnimation->setStartValue(0);
-    this->closeAnimation->setStartValue(this->containerAnimationMaxHeight);
-    this->openAnimation->setEndValue(this->containerAnimationMaxHeight);
-    this->closeAnimation->setEndValue(0);
-    this->openAnimation->setEasingCurve(
+    this->d->openAnimation->setTargetObject(this->d->container);
+    this->d->openAnimation->setPropertyName("maximumHeight");
+    this->d->closeAnimation->setTargetObject(this->d->container);
+    this->d->closeAnimation->setPropertyName("maximumHeight");
+
+    this->d->openAnimation->setDuration(
+        static_cast<int>(this->d->animationDuration));
+    this->d->closeAnimation->setDuration(
+        static_cast<int>(this->d->animationDuration));
+    this->d->openAnimation->setStartValue(0);
+    this->d->closeAnimation->setStartValue(this->getOpenHeight());
+    this->d->openAnimation->setEndValue(this->getOpenHeight());
+    this->d->closeAnimation->setEndValue(0);
+    this->d->openAnimation->setEasingCurve(
         QEasingCurve(QEasingCurve::Type::Linear));
-    this->closeAnimation->setEasingCurve(
+    this->d->closeAnimation->setEasingCurve(
         QEasingCurve(QEasingCurve::Type::Linear));
+
+    // count the frames to know how long a frame takes
+    QObject::connect(this->d->openAnimation.get(),
+                     &QPropertyAnimation::valueChanged, this, [this]() {
+                         QACCORDION_TRACE_INSTANT("ContentPane::openTick");
+                         this->d->animationFrames++;
+                         this->containerHeightChanged();
+                     });
+    QObject::connect(this->d->closeAnimation.get(),
+                     &QPropertyAnimation::valueChanged, this, [this]() {
+                         QACCORDION_TRACE_INSTANT("ContentPane::closeTick");
+                         this->d->animationFrames++;
+                         this->containerHeightChanged();
+                     });
+    QObject::connect(this->d->openAnimation.get(),
+                     &QPropertyAnimation::finished, this,
+                     &ContentPane::animationFinished);
+    QObject::connect(this->d->closeAnimation.get(),
+                     &QPropertyAnimation::finished, this,
+                     &ContentPane::animationFinished);
 }
 
 void ContentPane::headerTriggered(ATTR_UNUSED QPoint pos)
@@ -269,10 +919,29 @@ void ContentPane::headerTriggered(ATTR_UNUSED QPoint pos)
     emit this->clicked();
 }
 
-void ContentPane::paintEvent(ATTR_UNUSED QPaintEvent *event)
+void ContentPane::paintEvent(QPaintEvent *event)
+{
+    this->d->backgroundCache.paint(this, event);
+}
+
+void ContentPane::changeEvent(QEvent *event)
+{
+    if (event->type() == QEvent::ParentChange) {
+        this->containerHeightChanged();
+    }
+    if (event->type() == QEvent::StyleChange ||
+        event->type() == QEvent::PaletteChange ||
+        event->type() == QEvent::EnabledChange) {
+        this->d->backgroundCache.invalidate();
+        this->d->backgroundCache.update(this);
+    }
+    QWidget::changeEvent(event);
+}
+
+void ContentPane::resizeEvent(QResizeEvent *event)
 {
-    QStyleOption o;
-    o.initFrom(this);
-    QPainter p(this);
-    style()->drawPrimitive(QStyle::PE_Widget, &o, &p, this);
+    this->d->backgroundCache.update(this);
+    // height changes of open and close animations keep the preview
+    this->renderPreview();
+    QWidget::resizeEvent(event);
 }
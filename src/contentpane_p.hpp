@@ -0,0 +1,114 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CONTENTPANE_P_HPP
+#define CONTENTPANE_P_HPP
+
+#include <QFrame>
+#include <QImage>
+#include <QPixmap>
+#include <QPropertyAnimation>
+#include <QSet>
+#include <QString>
+#include <QVBoxLayout>
+
+#include <functional>
+#include <memory>
+
+#include "qaccordion/backgroundcache.hpp"
+#include "qaccordion/clickableframe.hpp"
+#include "qaccordion/contentpane.hpp"
+#include "qaccordion/heightcache.hpp"
+#include "qaccordion/slotmap.hpp"
+
+/*
+ * State of a ContentPane. It lives in this private header so contentpane.hpp
+ * does not have to pull in animations, painting and the caches. QAccordion is
+ * the only other class that includes it.
+ */
+struct ContentPanePrivate {
+    // handle of this pane in the slot map of the accordion that manages it
+    PaneHandle handle;
+    // key used by QAccordion::setPanes(), the header is used if empty
+    QString key;
+
+    ClickableFrame *header = nullptr;
+    QFrame *container = nullptr;
+    QVBoxLayout *containerLayout = nullptr;
+    QFrame *content = nullptr;
+    // content frame hidden while a preview is shown, restored if the content
+    // factory returns a nullptr
+    QFrame *previewedContent = nullptr;
+
+    std::function<QFrame *()> contentFactory;
+    // preview shown while the content factory has not been called yet,
+    // results of older renderers are ignored
+    QImage preview;
+    int previewRequest;
+    // kept until the content is built, the preview follows width changes
+    std::function<QImage(int width)> previewRenderer;
+    // width the current preview request was started for, -1 if none
+    int previewWidth;
+
+    QPixmap headerIconActive;
+    QPixmap headerIconInActive;
+    // paths of icons that are being loaded asynchronously
+    QString pendingIconActive;
+    QString pendingIconInActive;
+
+    int headerFrameStyle;
+    int contentPaneFrameStyle;
+    int containerAnimationMaxHeight;
+
+    bool autoHeight;
+    // the height was taken from the cache or measured from a preview
+    bool heightPending;
+    // the height has been measured from the real content at least once
+    bool heightVerified;
+    QString contentType;
+    // owned by the accordion
+    HeightCache *heightCache = nullptr;
+
+    bool active;
+    // false opens and closes the container without animation
+    bool animated;
+    uint animationDuration;
+
+    // created on first use, never in instant mode
+    std::unique_ptr<QPropertyAnimation> openAnimation;
+    std::unique_ptr<QPropertyAnimation> closeAnimation;
+    // frames of the current animation, average frame time of the last one in
+    // animation milliseconds or -1
+    int animationFrames;
+    int frameTime;
+
+    // outer pane the container height was reported to and that height
+    ContentPane *reportedTo = nullptr;
+    int reportedHeight;
+    // inner panes that report their height to this pane
+    QSet<ContentPane *> nestedPanes;
+    // height of the nested panes on top of containerAnimationMaxHeight, the
+    // changes that have not been applied yet are in nestedDelta
+    int nestedHeight;
+    int nestedDelta;
+    bool nestedUpdatePending;
+    // updateNestedHeight() is running, outer panes are updated right away
+    bool applyingNested;
+
+    BackgroundCache backgroundCache;
+};
+
+#endif  // CONTENTPANE_P_HPP
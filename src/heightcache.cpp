@@ -0,0 +1,108 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "qaccordion/heightcache.hpp"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+
+// format of the cache file
+static const quint32 HEIGHT_CACHE_MAGIC = 0x71616368;
+static const quint32 HEIGHT_CACHE_VERSION = 1;
+
+QString HeightCache::makeKey(const QString &header, const QString &contentType,
+                             int width, const QFont &font,
+                             qreal devicePixelRatio)
+{
+    // unit separator, not part of any sensible header
+    const QChar sep(0x1f);
+    return header + sep + contentType + sep +
+           QString::number(width / WIDTH_BUCKET) + sep + font.key() + sep +
+           QString::number(devicePixelRatio);
+}
+
+int HeightCache::lookup(const QString &key) const
+{
+    return this->heights.value(key, -1);
+}
+
+void HeightCache::insert(const QString &key, int height)
+{
+    this->heights.insert(key, height);
+}
+
+void HeightCache::remove(const QString &key) { this->heights.remove(key); }
+
+void HeightCache::clear() { this->heights.clear(); }
+
+int HeightCache::size() const { return this->heights.size(); }
+
+bool HeightCache::load(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.exists()) {
+        this->heights.clear();
+        return true;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        this->errorString =
+            "Can not open height cache " + fileName + ": " + file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_2);
+    quint32 magic = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+    if (magic != HEIGHT_CACHE_MAGIC || version != HEIGHT_CACHE_VERSION) {
+        this->errorString =
+            "Can not load height cache " + fileName + ", unknown format";
+        return false;
+    }
+    QHash<QString, int> heights;
+    stream >> heights;
+    if (stream.status() != QDataStream::Ok) {
+        this->errorString = "Can not load height cache " + fileName +
+                            ", file is truncated or corrupt";
+        return false;
+    }
+    this->heights = std::move(heights);
+    return true;
+}
+
+bool HeightCache::save(const QString &fileName)
+{
+    // never leave a half written cache behind
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        this->errorString =
+            "Can not open height cache " + fileName + ": " + file.errorString();
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_2);
+    stream << HEIGHT_CACHE_MAGIC << HEIGHT_CACHE_VERSION << this->heights;
+    if (!file.commit()) {
+        this->errorString = "Can not write height cache " + fileName + ": " +
+                            file.errorString();
+        return false;
+    }
+    return true;
+}
+
+QString HeightCache::getError() const { return this->errorString; }
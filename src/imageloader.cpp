@@ -0,0 +1,147 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "qaccordion/imageloader.hpp"
+
+#include <QCoreApplication>
+#include <QImageReader>
+#include <QPixmapCache>
+#include <QRunnable>
+
+#include "qaccordion/accordiontrace.hpp"
+
+static QString pixmapCacheKey(const QString &path)
+{
+    return QStringLiteral("qaccordion:") + path;
+}
+
+/*
+ * Decodes one image and hands it back to the loader on the GUI thread. The
+ * thread pool is a member of the loader and waits for all runnables before
+ * the loader is gone.
+ */
+class ImageLoaderTask : public QRunnable
+{
+public:
+    ImageLoaderTask(ImageLoader *loader, QString path)
+        : loader(loader), path(std::move(path))
+    {
+    }
+
+    void run() override
+    {
+        QACCORDION_TRACE_SCOPE("ImageLoader::decode");
+        QImageReader reader(this->path);
+        QImage image = reader.read();
+        QMetaObject::invokeMethod(this->loader, "deliver",
+                                  Qt::QueuedConnection,
+                                  Q_ARG(QString, this->path),
+                                  Q_ARG(QImage, image));
+    }
+
+private:
+    ImageLoader *loader;
+    QString path;
+};
+
+class ImageRenderTask : public QRunnable
+{
+public:
+    ImageRenderTask(ImageLoader *loader, quint64 id,
+                    std::function<QImage()> renderer)
+        : loader(loader), id(id), renderer(std::move(renderer))
+    {
+    }
+
+    void run() override
+    {
+        QACCORDION_TRACE_SCOPE("ImageLoader::render");
+        QImage image = this->renderer();
+        QMetaObject::invokeMethod(this->loader, "deliverRender",
+                                  Qt::QueuedConnection,
+                                  Q_ARG(quint64, this->id),
+                                  Q_ARG(QImage, image));
+    }
+
+private:
+    ImageLoader *loader;
+    quint64 id;
+    std::function<QImage()> renderer;
+};
+
+ImageLoader *ImageLoader::instance()
+{
+    static QPointer<ImageLoader> loader;
+    if (loader.isNull()) {
+        loader = new ImageLoader(QCoreApplication::instance());
+    }
+    return loader;
+}
+
+void ImageLoader::load(const QString &path, QObject *receiver,
+                       std::function<void(const QPixmap &)> callback)
+{
+    QPixmap pixmap;
+    if (QPixmapCache::find(pixmapCacheKey(path), &pixmap)) {
+        callback(pixmap);
+        return;
+    }
+
+    auto it = this->pending.find(path);
+    if (it != this->pending.end()) {
+        // the image is already being decoded
+        it->push_back({receiver, std::move(callback)});
+        return;
+    }
+    this->pending[path].push_back({receiver, std::move(callback)});
+    this->pool.start(new ImageLoaderTask(this, path));
+}
+
+void ImageLoader::render(std::function<QImage()> renderer, QObject *receiver,
+                         std::function<void(const QImage &)> callback)
+{
+    quint64 id = this->nextRender++;
+    this->renders.insert(id, {receiver, std::move(callback)});
+    this->pool.start(new ImageRenderTask(this, id, std::move(renderer)));
+}
+
+ImageLoader::ImageLoader(QObject *parent) : QObject(parent), nextRender(0) {}
+
+ImageLoader::~ImageLoader() { this->pool.waitForDone(); }
+
+void ImageLoader::deliver(const QString &path, const QImage &image)
+{
+    QACCORDION_TRACE_SCOPE("ImageLoader::deliver");
+    QPixmap pixmap;
+    if (!image.isNull()) {
+        pixmap = QPixmap::fromImage(image);
+        QPixmapCache::insert(pixmapCacheKey(path), pixmap);
+    }
+    std::vector<Request> requests = this->pending.take(path);
+    for (const Request &request : requests) {
+        if (!request.receiver.isNull()) {
+            request.callback(pixmap);
+        }
+    }
+}
+
+void ImageLoader::deliverRender(quint64 id, const QImage &image)
+{
+    RenderRequest request = this->renders.take(id);
+    if (!request.receiver.isNull()) {
+        request.callback(image);
+    }
+}
@@ -0,0 +1,331 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "qaccordion/listcontentpane.hpp"
+
+#include <QAbstractListModel>
+#include <QDebug>
+#include <QEvent>
+#include <QHash>
+#include <QList>
+#include <QVector>
+
+#include <algorithm>
+
+#include "qaccordion/accordiontrace.hpp"
+
+namespace
+{
+// number of pages of the data source that are kept besides the visible ones
+const int SPARE_PAGES = 2;
+}  // namespace
+
+/*
+ * Rows of a ListContentPane.
+ *
+ * Appended rows are stored and capped at maximumRows, the oldest rows are
+ * dropped. Rows of a data source are not stored. The model only counts them
+ * and keeps the last used pages of batchSize rows, a page that is not cached
+ * is requested from the source again. The memory of the model does not depend
+ * on the number of rows of the source.
+ */
+class ListContentModel : public QAbstractListModel
+{
+public:
+    explicit ListContentModel(QObject *parent) : QAbstractListModel(parent)
+    {
+        this->sourceRows = 0;
+        this->sourceEnded = false;
+        this->batchSize = 100;
+        this->maximumRows = 100000;
+        this->visibleRows = 0;
+    }
+
+    int rowCount(const QModelIndex &parent) const override
+    {
+        if (parent.isValid()) {
+            return 0;
+        }
+        return this->source ? this->sourceRows : this->rows.size();
+    }
+
+    QVariant data(const QModelIndex &index, int role) const override
+    {
+        if (!index.isValid() || index.row() >= this->rowCount(QModelIndex()) ||
+            (role != Qt::DisplayRole && role != Qt::ToolTipRole)) {
+            return QVariant();
+        }
+        if (!this->source) {
+            return this->rows.at(index.row());
+        }
+        const QStringList &page = this->page(index.row() / this->batchSize);
+        int row = index.row() % this->batchSize;
+        // the source may return less rows than it did before
+        return row < page.size() ? page.at(row) : QVariant();
+    }
+
+    bool canFetchMore(const QModelIndex &parent) const override
+    {
+        return !parent.isValid() && this->source && !this->sourceEnded;
+    }
+
+    void fetchMore(const QModelIndex &parent) override
+    {
+        if (!this->canFetchMore(parent)) {
+            return;
+        }
+        QACCORDION_TRACE_SCOPE("ListContentModel::fetchMore");
+        QStringList batch = this->source(this->sourceRows, this->batchSize);
+        if (batch.size() < this->batchSize) {
+            this->sourceEnded = true;
+        }
+        if (batch.isEmpty()) {
+            return;
+        }
+        int count = batch.size();
+        this->beginInsertRows(QModelIndex(), this->sourceRows,
+                              this->sourceRows + count - 1);
+        this->cachePage(this->sourceRows / this->batchSize, std::move(batch));
+        this->sourceRows += count;
+        this->endInsertRows();
+    }
+
+    void append(const QStringList &batch)
+    {
+        if (batch.isEmpty()) {
+            return;
+        }
+        if (this->source) {
+            // appended rows replace the rows of the data source
+            this->clear();
+        }
+        int count = std::min(batch.size(), this->maximumRows);
+        this->dropRows(this->rows.size() + count - this->maximumRows);
+        this->beginInsertRows(QModelIndex(), this->rows.size(),
+                              this->rows.size() + count - 1);
+        this->rows.reserve(this->rows.size() + count);
+        for (auto it = batch.end() - count; it != batch.end(); ++it) {
+            this->rows.append(*it);
+        }
+        this->endInsertRows();
+    }
+
+    void clear()
+    {
+        this->beginResetModel();
+        this->rows.clear();
+        this->rows.squeeze();
+        this->pages.clear();
+        this->pageOrder.clear();
+        this->source = nullptr;
+        this->sourceRows = 0;
+        this->sourceEnded = false;
+        this->endResetModel();
+    }
+
+    void setSource(std::function<QStringList(int, int)> source, int batchSize)
+    {
+        this->clear();
+        this->source = std::move(source);
+        this->batchSize = std::max(batchSize, 1);
+    }
+
+    void setMaximumRows(int rows)
+    {
+        this->maximumRows = std::max(rows, 1);
+        if (!this->source) {
+            this->dropRows(this->rows.size() - this->maximumRows);
+        }
+    }
+
+    int getMaximumRows() const { return this->maximumRows; }
+
+    void setVisibleRows(int rows) { this->visibleRows = rows; }
+
+private:
+    QVector<QString> rows;
+    std::function<QStringList(int, int)> source;
+    // pages of the source by page number, pageOrder starts with the least
+    // recently used one
+    mutable QHash<int, QStringList> pages;
+    mutable QList<int> pageOrder;
+    int sourceRows;
+    bool sourceEnded;
+    int batchSize;
+    int maximumRows;
+    int visibleRows;
+
+    // remove the oldest count appended rows
+    void dropRows(int count)
+    {
+        if (count <= 0) {
+            return;
+        }
+        this->beginRemoveRows(QModelIndex(), 0, count - 1);
+        this->rows.remove(0, count);
+        this->endRemoveRows();
+    }
+
+    const QStringList &page(int number) const
+    {
+        auto it = this->pages.constFind(number);
+        if (it != this->pages.constEnd()) {
+            this->pageOrder.removeOne(number);
+            this->pageOrder.append(number);
+            return it.value();
+        }
+        QACCORDION_TRACE_SCOPE("ListContentModel::page");
+        return this->cachePage(
+            number, this->source(number * this->batchSize, this->batchSize));
+    }
+
+    const QStringList &cachePage(int number, QStringList rows) const
+    {
+        // the visible rows may span one page more than they fill
+        int maximumPages = (this->visibleRows + this->batchSize - 1) /
+                               this->batchSize +
+                           1 + SPARE_PAGES;
+        while (this->pageOrder.size() >= maximumPages) {
+            this->pages.remove(this->pageOrder.takeFirst());
+        }
+        this->pageOrder.append(number);
+        return this->pages.insert(number, std::move(rows)).value();
+    }
+};
+
+ListContentPane::ListContentPane(QString header, QWidget *parent)
+    : ContentPane(std::move(header), parent)
+{
+    this->initList(new QListView());
+}
+
+ListContentPane::ListContentPane(QString header, QFrame *content,
+                                 QWidget *parent)
+    : ContentPane(std::move(header), parent)
+{
+    auto *view = qobject_cast<QListView *>(content);
+    if (content != nullptr && view == nullptr) {
+        qDebug() << Q_FUNC_INFO
+                 << "Content frame is not a QListView, it is not used";
+    }
+    this->initList(view != nullptr ? view : new QListView());
+}
+
+ListContentPane::~ListContentPane() = default;
+
+void ListContentPane::initList(QListView *view)
+{
+    this->maximumVisibleRows = 10;
+    this->listModel = new ListContentModel(this);
+    this->listModel->setVisibleRows(this->maximumVisibleRows);
+
+    // QListView is a QFrame, it is the content frame itself
+    this->view = view;
+    this->view->setFrameShape(QFrame::NoFrame);
+    this->view->setUniformItemSizes(true);
+    this->view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    this->view->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    this->setContentFrame(this->view);
+
+    this->connectModel(this->listModel);
+}
+
+void ListContentPane::appendRows(const QStringList &rows)
+{
+    if (this->model != this->listModel) {
+        this->connectModel(this->listModel);
+    }
+    this->listModel->append(rows);
+}
+
+void ListContentPane::clearRows() { this->listModel->clear(); }
+
+void ListContentPane::setDataSource(
+    std::function<QStringList(int first, int count)> source, int batchSize)
+{
+    if (this->model != this->listModel) {
+        this->connectModel(this->listModel);
+    }
+    this->listModel->setSource(std::move(source), batchSize);
+    // the first batch sizes the container before the pane is opened
+    this->listModel->fetchMore(QModelIndex());
+}
+
+void ListContentPane::setModel(QAbstractItemModel *model)
+{
+    this->connectModel(model != nullptr ? model : this->listModel);
+}
+
+QAbstractItemModel *ListContentPane::getModel() const { return this->model; }
+
+QListView *ListContentPane::getListView() const { return this->view; }
+
+void ListContentPane::setMaximumRows(int rows)
+{
+    this->listModel->setMaximumRows(rows);
+}
+
+int ListContentPane::getMaximumRows() const
+{
+    return this->listModel->getMaximumRows();
+}
+
+void ListContentPane::setMaximumVisibleRows(int rows)
+{
+    this->maximumVisibleRows = std::max(rows, 0);
+    this->listModel->setVisibleRows(this->maximumVisibleRows);
+    this->updateHeight();
+}
+
+int ListContentPane::getMaximumVisibleRows() const
+{
+    return this->maximumVisibleRows;
+}
+
+void ListContentPane::connectModel(QAbstractItemModel *model)
+{
+    if (!this->model.isNull()) {
+        QObject::disconnect(this->model, nullptr, this, nullptr);
+    }
+    this->model = model;
+    this->view->setModel(model);
+
+    auto update = [this]() { this->updateHeight(); };
+    QObject::connect(model, &QAbstractItemModel::rowsInserted, this, update);
+    QObject::connect(model, &QAbstractItemModel::rowsRemoved, this, update);
+    QObject::connect(model, &QAbstractItemModel::modelReset, this, update);
+    QObject::connect(model, &QAbstractItemModel::layoutChanged, this, update);
+    this->updateHeight();
+}
+
+void ListContentPane::updateHeight()
+{
+    int rows = this->model.isNull() ? 0 : this->model->rowCount();
+    int visibleRows = std::min(rows, this->maximumVisibleRows);
+    // all rows have the height of the first one
+    int rowHeight = visibleRows > 0 ? this->view->sizeHintForRow(0) : 0;
+    this->setContentHeight(visibleRows * rowHeight +
+                           2 * this->view->frameWidth());
+}
+
+void ListContentPane::changeEvent(QEvent *event)
+{
+    ContentPane::changeEvent(event);
+    if (event->type() == QEvent::FontChange ||
+        event->type() == QEvent::StyleChange) {
+        this->updateHeight();
+    }
+}
@@ -0,0 +1,318 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "qaccordion/logcontentpane.hpp"
+
+#include <QAbstractScrollArea>
+#include <QCache>
+#include <QDebug>
+#include <QEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QStaticText>
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "qaccordion/accordiontrace.hpp"
+
+namespace
+{
+// number of lines in one chunk of the storage
+const int CHUNK_LINES = 1024;
+// number of laid out lines that are kept
+const int GLYPH_CACHE_LINES = 256;
+// interval in which appended lines are painted
+const int FRAME_INTERVAL = 16;
+}  // namespace
+
+/*
+ * Storage and viewport of a LogContentPane.
+ *
+ * Lines are kept in chunks of CHUNK_LINES. All chunks but the last one are
+ * full, so a line is found by dividing its index. When the maximum number of
+ * lines is exceeded the first chunk is dropped and kept as spare for the next
+ * chunk, the storage does not allocate once it is saturated.
+ *
+ * Glyph runs are cached per absolute line number. The absolute number of a
+ * line does not change when older lines are dropped.
+ */
+class LogView : public QAbstractScrollArea
+{
+public:
+    explicit LogView(QWidget *parent = nullptr) : QAbstractScrollArea(parent)
+    {
+        this->droppedLines = 0;
+        this->shownDroppedLines = 0;
+        this->lineCount = 0;
+        this->maximumLines = 100000;
+        this->pendingLines = false;
+        this->glyphs.setMaxCost(GLYPH_CACHE_LINES);
+        this->setFrameShape(QFrame::NoFrame);
+        this->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+        this->viewport()->setAutoFillBackground(false);
+    }
+
+    void append(const QString &line)
+    {
+        if (this->chunks.empty() ||
+            static_cast<int>(this->chunks.back().size()) == CHUNK_LINES) {
+            this->chunks.emplace_back(std::move(this->spare));
+            this->spare = std::vector<QString>();
+            this->chunks.back().reserve(CHUNK_LINES);
+        }
+        this->chunks.back().push_back(line);
+        this->lineCount++;
+        this->pendingLines = true;
+        this->dropLines();
+    }
+
+    void clear()
+    {
+        this->droppedLines += this->lineCount;
+        this->chunks.clear();
+        this->spare = std::vector<QString>();
+        this->lineCount = 0;
+        this->glyphs.clear();
+        this->pendingLines = true;
+    }
+
+    int getLineCount() const { return this->lineCount; }
+
+    void setMaximumLines(int lines)
+    {
+        this->maximumLines = std::max(lines, 1);
+        this->dropLines();
+    }
+
+    int getMaximumLines() const { return this->maximumLines; }
+
+    bool hasPendingLines() const { return this->pendingLines; }
+
+    void flush()
+    {
+        QACCORDION_TRACE_SCOPE("LogView::flush");
+        QScrollBar *bar = this->verticalScrollBar();
+        bool followTail = bar->value() == bar->maximum();
+        // scroll position as absolute line number
+        qint64 top = this->shownDroppedLines + bar->value();
+        int lineHeight = this->fontMetrics().lineSpacing();
+        int pageLines = std::max(this->viewport()->height() / lineHeight, 1);
+        bar->setPageStep(pageLines);
+        bar->setRange(0, std::max(this->lineCount - pageLines, 0));
+        if (followTail) {
+            bar->setValue(bar->maximum());
+        } else {
+            bar->setValue(static_cast<int>(
+                std::max<qint64>(top - this->droppedLines, 0)));
+        }
+        this->shownDroppedLines = this->droppedLines;
+        this->pendingLines = false;
+        this->viewport()->update();
+    }
+
+protected:
+    void paintEvent(QPaintEvent *event) override
+    {
+        Q_UNUSED(event);
+        QACCORDION_TRACE_SCOPE("LogView::paintEvent");
+        QPainter p(this->viewport());
+        int lineHeight = this->fontMetrics().lineSpacing();
+        // the scroll bar counts lines from the last flush, lines may have been
+        // dropped since then
+        int first = static_cast<int>(std::max<qint64>(
+            this->verticalScrollBar()->value() -
+                (this->droppedLines - this->shownDroppedLines),
+            0));
+        int last = std::min(
+            first + this->viewport()->height() / lineHeight + 1,
+            this->lineCount);
+        int y = 0;
+        for (int i = first; i < last; i++) {
+            p.drawStaticText(0, y, *this->glyphRun(i));
+            y += lineHeight;
+        }
+    }
+
+    void resizeEvent(QResizeEvent *event) override
+    {
+        QAbstractScrollArea::resizeEvent(event);
+        this->flush();
+    }
+
+    void changeEvent(QEvent *event) override
+    {
+        QAbstractScrollArea::changeEvent(event);
+        if (event->type() == QEvent::FontChange) {
+            // glyph runs are laid out for the old font
+            this->glyphs.clear();
+            this->flush();
+        }
+    }
+
+private:
+    std::deque<std::vector<QString>> chunks;
+    std::vector<QString> spare;
+    QCache<qint64, QStaticText> glyphs;
+    qint64 droppedLines;
+    qint64 shownDroppedLines;
+    int lineCount;
+    int maximumLines;
+    bool pendingLines;
+
+    void dropLines()
+    {
+        while (this->chunks.size() > 1 &&
+               this->lineCount -
+                       static_cast<int>(this->chunks.front().size()) >=
+                   this->maximumLines) {
+            int chunkLines = static_cast<int>(this->chunks.front().size());
+            this->spare = std::move(this->chunks.front());
+            this->spare.clear();
+            this->chunks.pop_front();
+            this->lineCount -= chunkLines;
+            this->droppedLines += chunkLines;
+        }
+    }
+
+    QStaticText *glyphRun(int index)
+    {
+        qint64 key = this->droppedLines + index;
+        QStaticText *text = this->glyphs.object(key);
+        if (text == nullptr) {
+            const QString &line = this->chunks.at(index / CHUNK_LINES)
+                                      .at(index % CHUNK_LINES);
+            text = new QStaticText(line);
+            text->setTextFormat(Qt::PlainText);
+            text->setPerformanceHint(QStaticText::AggressiveCaching);
+            text->prepare(QTransform(), this->font());
+            this->glyphs.insert(key, text);
+        }
+        return text;
+    }
+};
+
+LogContentPane::LogContentPane(QString header, QWidget *parent)
+    : ContentPane(std::move(header), parent)
+{
+    this->initLog();
+}
+
+LogContentPane::LogContentPane(QString header, QFrame *content,
+                               QWidget *parent)
+    : ContentPane(std::move(header), parent)
+{
+    if (content != nullptr) {
+        qDebug() << Q_FUNC_INFO
+                 << "Content frame is not used, the pane creates its own view";
+    }
+    this->initLog();
+}
+
+LogContentPane::~LogContentPane() = default;
+
+void LogContentPane::initLog()
+{
+    this->visibleLines = 15;
+    this->view = new LogView();
+    this->setContentFrame(this->view);
+
+    this->frameTimer.setSingleShot(true);
+    this->frameTimer.setInterval(FRAME_INTERVAL);
+    QObject::connect(&this->frameTimer, &QTimer::timeout, this,
+                     &LogContentPane::flush);
+    // catch up with the lines that were appended while the pane was closed
+    // before the open animation shows them
+    QObject::connect(this, &ContentPane::aboutToOpen, this,
+                     &LogContentPane::flush);
+    this->updateHeight();
+}
+
+void LogContentPane::appendLine(const QString &line)
+{
+    this->view->append(line);
+    this->scheduleFrame();
+}
+
+void LogContentPane::appendLines(const QStringList &lines)
+{
+    for (const QString &line : lines) {
+        this->view->append(line);
+    }
+    this->scheduleFrame();
+}
+
+void LogContentPane::clear()
+{
+    this->view->clear();
+    this->scheduleFrame();
+}
+
+int LogContentPane::getLineCount() const
+{
+    return this->view->getLineCount();
+}
+
+void LogContentPane::setMaximumLines(int lines)
+{
+    this->view->setMaximumLines(lines);
+    this->scheduleFrame();
+}
+
+int LogContentPane::getMaximumLines() const
+{
+    return this->view->getMaximumLines();
+}
+
+void LogContentPane::setVisibleLines(int lines)
+{
+    this->visibleLines = std::max(lines, 1);
+    this->updateHeight();
+}
+
+int LogContentPane::getVisibleLines() const { return this->visibleLines; }
+
+void LogContentPane::scheduleFrame()
+{
+    // closed panes only store lines, flush() runs when the pane is opened
+    if (!this->getActive() || this->frameTimer.isActive()) {
+        return;
+    }
+    this->frameTimer.start();
+}
+
+void LogContentPane::flush()
+{
+    if (this->view->hasPendingLines()) {
+        this->view->flush();
+    }
+}
+
+void LogContentPane::updateHeight()
+{
+    // the view inherits the font of the pane
+    this->setContentHeight(this->visibleLines *
+                           this->fontMetrics().lineSpacing());
+}
+
+void LogContentPane::changeEvent(QEvent *event)
+{
+    ContentPane::changeEvent(event);
+    if (event->type() == QEvent::FontChange) {
+        this->updateHeight();
+    }
+}
@@ -0,0 +1,108 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "qaccordion/memoryfootprint.hpp"
+
+#include <QArrayData>
+#include <QBoxLayout>
+#include <QLabel>
+#include <QLayout>
+#include <QPropertyAnimation>
+#include <QWidget>
+
+// Approximate sizes of the private data Qt allocates behind the d-pointer of
+// its objects (64 bit, Qt 5)
+static const std::size_t OBJECT_PRIVATE_SIZE = 120;
+static const std::size_t WIDGET_PRIVATE_SIZE = 650;
+// QWExtra, allocated once a widget has size constraints, a cursor or a style
+// sheet
+static const std::size_t WIDGET_EXTRA_SIZE = 160;
+static const std::size_t LABEL_PRIVATE_SIZE = 250;
+static const std::size_t LAYOUT_PRIVATE_SIZE = 200;
+static const std::size_t LAYOUT_ITEM_SIZE = 48;
+static const std::size_t ANIMATION_PRIVATE_SIZE = 260;
+static const std::size_t PIXMAP_PRIVATE_SIZE = 120;
+
+std::size_t MemoryFootprint::total() const
+{
+    return this->widgets + this->layouts + this->animations + this->pixmaps +
+           this->strings + this->content + this->other;
+}
+
+MemoryFootprint &MemoryFootprint::operator+=(const MemoryFootprint &other)
+{
+    this->widgets += other.widgets;
+    this->layouts += other.layouts;
+    this->animations += other.animations;
+    this->pixmaps += other.pixmaps;
+    this->strings += other.strings;
+    this->content += other.content;
+    this->other += other.other;
+    return *this;
+}
+
+std::size_t MemoryFootprint::estimateObject(const QObject *object)
+{
+    if (object == nullptr) {
+        return 0;
+    }
+    if (object->isWidgetType()) {
+        const auto *widget = static_cast<const QWidget *>(object);
+        std::size_t size = sizeof(QWidget) + WIDGET_PRIVATE_SIZE;
+        if (qobject_cast<const QLabel *>(object) != nullptr) {
+            size += sizeof(QLabel) - sizeof(QWidget) + LABEL_PRIVATE_SIZE;
+        }
+        if (widget->minimumHeight() > 0 || widget->minimumWidth() > 0 ||
+            widget->maximumHeight() < QWIDGETSIZE_MAX ||
+            widget->maximumWidth() < QWIDGETSIZE_MAX ||
+            widget->testAttribute(Qt::WA_SetCursor) ||
+            !widget->styleSheet().isEmpty()) {
+            size += WIDGET_EXTRA_SIZE;
+        }
+        return size;
+    }
+    if (const auto *layout = qobject_cast<const QLayout *>(object)) {
+        return sizeof(QBoxLayout) + LAYOUT_PRIVATE_SIZE +
+               static_cast<std::size_t>(layout->count()) * LAYOUT_ITEM_SIZE;
+    }
+    if (qobject_cast<const QPropertyAnimation *>(object) != nullptr) {
+        return sizeof(QPropertyAnimation) + ANIMATION_PRIVATE_SIZE;
+    }
+    return sizeof(QObject) + OBJECT_PRIVATE_SIZE;
+}
+
+std::size_t MemoryFootprint::estimateString(const QString &string)
+{
+    // null strings point to shared static data
+    if (string.isNull()) {
+        return 0;
+    }
+    return sizeof(QArrayData) +
+           (static_cast<std::size_t>(string.capacity()) + 1) * sizeof(QChar);
+}
+
+std::size_t MemoryFootprint::estimatePixmap(const QPixmap &pixmap,
+                                            QSet<qint64> &seen)
+{
+    if (pixmap.isNull() || seen.contains(pixmap.cacheKey())) {
+        return 0;
+    }
+    seen.insert(pixmap.cacheKey());
+    return PIXMAP_PRIVATE_SIZE + static_cast<std::size_t>(pixmap.width()) *
+                                     static_cast<std::size_t>(pixmap.height()) *
+                                     static_cast<std::size_t>(pixmap.depth()) /
+                                     8;
+}
@@ -16,30 +16,122 @@
 
 #include "qaccordion/qaccordion.hpp"
 
-QAccordion::QAccordion(QWidget *parent) : QWidget(parent)
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QHash>
+#include <QHoverEvent>
+#include <QScrollBar>
+#include <QSet>
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+#include "qaccordion/accordionlayout.hpp"
+#include "qaccordion/accordiontrace.hpp"
+
+#include "contentpane_p.hpp"
+#include "qaccordion_p.hpp"
+
+using PaneTransition = QAccordionPrivate::PaneTransition;
+using PaneUsage = QAccordionPrivate::PaneUsage;
+using Section = QAccordionPrivate::Section;
+
+// ANIMATION::AUTO thresholds
+static const std::size_t AUTO_ANIMATION_MAX_PANES = 1000;
+static const int AUTO_ANIMATION_MAX_FRAME_TIME = 50;
+// milliseconds after which the measured frame time has halved
+static const qint64 AUTO_ANIMATION_FRAME_TIME_HALF_LIFE = 10000;
+// format of saveUsageStatistics()
+static const quint32 USAGE_STATISTICS_MAGIC = 0x71616375;
+static const quint32 USAGE_STATISTICS_VERSION = 1;
+static const qint64 MSECS_PER_DAY = 24 * 60 * 60 * 1000;
+
+// left indent of the content panes of a section
+static const int SECTION_INDENT = 16;
+
+/*
+ * Longest strictly increasing subsequence of values. Returns a flag for every
+ * element that is part of the subsequence. O(n log n).
+ */
+static std::vector<bool> longestIncreasingSubsequence(
+    const std::vector<int> &values)
 {
-    // make sure our resource file gets initialized
-    Q_INIT_RESOURCE(qaccordionicons);
+    // tails[k] is the index of the smallest tail of all subsequences with
+    // length k + 1
+    std::vector<std::size_t> tails;
+    std::vector<int> previous(values.size(), -1);
+    for (std::size_t i = 0; i < values.size(); i++) {
+        auto it = std::lower_bound(tails.begin(), tails.end(), values.at(i),
+                                   [&values](std::size_t index, int value) {
+                                       return values.at(index) < value;
+                                   });
+        if (it != tails.begin()) {
+            previous.at(i) = static_cast<int>(*(it - 1));
+        }
+        if (it == tails.end()) {
+            tails.push_back(i);
+        } else {
+            *it = i;
+        }
+    }
 
-    this->multiActive = false;
-    this->collapsible = true;
+    std::vector<bool> member(values.size(), false);
+    int i = tails.empty() ? -1 : static_cast<int>(tails.back());
+    while (i != -1) {
+        member.at(i) = true;
+        i = previous.at(i);
+    }
+    return member;
+}
 
-    // set our basic layout
-    this->setLayout(new QVBoxLayout());
+QAccordion::QAccordion(QWidget *parent)
+    : QWidget(parent), d(std::make_unique<QAccordionPrivate>())
+{
+    // make sure our resource file gets initialized
+    Q_INIT_RESOURCE(qaccordionicons);
 
-    // add a stretch to the end so all content panes are at the top
-    dynamic_cast<QVBoxLayout *>(this->layout())->addStretch();
-    this->layout()->setSpacing(1);
-    this->layout()->setContentsMargins(QMargins());
-    // TODO: Do we need to keep a pointer to the spacer?
-    this->spacer = dynamic_cast<QSpacerItem *>(this->layout()->itemAt(0));
+    this->d->multiActive = false;
+    this->d->collapsible = true;
+    this->d->animationPolicy = ANIMATION::ANIMATED;
+    this->d->bulkOperations = 0;
+    this->d->frameTime = -1;
+    this->d->stickyHeaderLowered = false;
+    this->d->usageTracking = false;
+    this->d->prefetchCount = 3;
+
+    this->d->prefetchTimer.setSingleShot(true);
+    this->d->prefetchTimer.setInterval(0);
+    QObject::connect(&this->d->prefetchTimer, &QTimer::timeout, this,
+                     &QAccordion::prefetchContent);
+
+    // set our basic layout. the accordion layout keeps all content panes at
+    // the top
+    this->d->layout = new AccordionLayout();
+    this->setLayout(this->d->layout);
+    this->d->layout->setSpacing(1);
+    this->d->layout->setContentsMargins(QMargins());
+
+    // same hover effect headers used to set up individually
+    HeaderStyle headerStyle;
+    headerStyle.hoverBackground =
+        this->palette().color(QPalette::ColorRole::Background).lighter(110);
+    this->d->headerStyle = std::make_shared<const HeaderStyle>(headerStyle);
+    // hover events of all headers end up here, see event()
+    this->setAttribute(Qt::WA_Hover, true);
 
     // seome things we want to do if the number of panes change
     QObject::connect(this, &QAccordion::numberOfContentPanesChanged, this,
                      &QAccordion::numberOfPanesChanged);
 }
 
-int QAccordion::numberOfContentPanes() const { return this->contentPanes.size(); }
+QAccordion::~QAccordion() = default;
+
+int QAccordion::numberOfContentPanes() const
+{
+    return this->d->contentPanes.size();
+}
 
 int QAccordion::addContentPane(QString header)
 {
@@ -75,6 +167,7 @@ bool QAccordion::insertContentPane(uint index, ContentPane *cpane)
 
 bool QAccordion::swapContentPane(uint index, ContentPane *cpane)
 {
+    QACCORDION_TRACE_SCOPE("QAccordion::swapContentPane");
     if (this->checkIndexError(index, false,
                               "Can not swap content pane at index " +
                                   QString::number(index) +
@@ -82,24 +175,24 @@ bool QAccordion::swapContentPane(uint index, ContentPane *cpane)
         return false;
     }
 
+    if (cpane == nullptr) {
+        this->d->errorString =
+            "Can not swap content pane as the new pane is a nullptr";
+        return false;
+    }
+
     if (this->findContentPaneIndex("", nullptr, cpane) != -1) {
-        this->errorString =
+        this->d->errorString =
             "Can not swap content pane as new pane is already "
             "managed by accordion widget";
         return false;
     }
 
-    // remove the old content pane from the accordion layout
-    dynamic_cast<QVBoxLayout *>(this->layout())
-        ->removeWidget(this->contentPanes.at(index));
-    delete this->contentPanes.at(index);
-
-    // add the new content pane to the appropriate vector
-    this->contentPanes.at(index) = cpane;
-
-    // add the new content pane to the layout
-    dynamic_cast<QVBoxLayout *>(this->layout())
-        ->insertWidget(index, this->contentPanes.at(index));
+    // remove the old content pane and put the new one in its place
+    delete this->detachContentPane(index);
+    emit panesRemoved(index, index);
+    this->attachContentPane(index, cpane);
+    emit panesInserted(index, index);
 
     return true;
 }
@@ -125,8 +218,21 @@ bool QAccordion::removeContentPane(bool deleteObject, ContentPane *contentPane)
                                            contentPane);
 }
 
+bool QAccordion::removeContentPane(bool deleteObject, PaneHandle handle)
+{
+    ContentPane *cpane = this->getContentPane(handle);
+    if (cpane == nullptr) {
+        this->d->errorString =
+            "Can not remove content pane as the handle is stale or invalid";
+        return false;
+    }
+    return this->internalRemoveContentPane(
+        deleteObject, this->d->layout->indexOf(cpane));
+}
+
 bool QAccordion::moveContentPane(uint currentIndex, uint newIndex)
 {
+    QACCORDION_TRACE_SCOPE("QAccordion::moveContentPane");
     if (this->checkIndexError(currentIndex, false,
                               "Can not move from " +
                                   QString::number(currentIndex) +
@@ -137,17 +243,323 @@ bool QAccordion::moveContentPane(uint currentIndex, uint newIndex)
         return false;
     }
 
-    auto *layout = dynamic_cast<QVBoxLayout *>(this->layout());
-    // get the pane we want to move
-    ContentPane *movePane = this->contentPanes.at(currentIndex);
+    this->relocateContentPane(currentIndex, newIndex);
 
-    // remove the widget from the layout and insert it at the new position
-    layout->removeWidget(movePane);
-    layout->insertWidget(newIndex, movePane);
+    emit panesMoved(currentIndex, currentIndex, newIndex);
 
-    // keep our vector synchronized
-    this->contentPanes.erase(this->contentPanes.begin() + currentIndex);
-    this->contentPanes.insert(this->contentPanes.begin() + newIndex, movePane);
+    return true;
+}
+
+bool QAccordion::setPanes(const std::vector<PaneSpec> &panes)
+{
+    QACCORDION_TRACE_SCOPE("QAccordion::setPanes");
+    // keys have to be unique, otherwise we can not match panes
+    QHash<QString, int> specIndex;
+    specIndex.reserve(static_cast<int>(panes.size()));
+    for (std::size_t j = 0; j < panes.size(); j++) {
+        const PaneSpec &spec = panes.at(j);
+        const QString &key = spec.key.isEmpty() ? spec.header : spec.key;
+        if (specIndex.contains(key)) {
+            this->d->errorString =
+                "Can not set content panes as key " + key + " is not unique";
+            return false;
+        }
+        specIndex.insert(key, static_cast<int>(j));
+    }
+
+    const std::size_t oldNumberOfPanes = this->d->contentPanes.size();
+    // no intermediate repaints while we apply the diff
+    const bool updatesEnabled = this->updatesEnabled();
+    this->setUpdatesEnabled(false);
+    this->d->bulkOperations++;
+
+    // match the existing content panes with the specs. targets holds the
+    // spec index for every content pane or -1 if it has to be removed.
+    std::vector<ContentPane *> specPanes(panes.size(), nullptr);
+    std::vector<int> targets;
+    targets.reserve(this->d->contentPanes.size());
+    for (ContentPane *cpane : this->d->contentPanes) {
+        auto it = specIndex.constFind(this->contentPaneKey(cpane));
+        int target = -1;
+        if (it != specIndex.constEnd() && specPanes.at(it.value()) == nullptr) {
+            target = it.value();
+            specPanes.at(target) = cpane;
+        }
+        targets.push_back(target);
+    }
+
+    // remove from the back so every contiguous range is reported once with
+    // indexes that are valid for the observers
+    int rangeLast = -1;
+    for (int i = static_cast<int>(targets.size()) - 1; i >= -1; i--) {
+        if (i >= 0 && targets.at(i) == -1) {
+            if (rangeLast == -1) {
+                rangeLast = i;
+            }
+            continue;
+        }
+        if (rangeLast != -1) {
+            for (ContentPane *cpane :
+                 this->detachContentPanes(i + 1, rangeLast - i)) {
+                delete cpane;
+            }
+            emit panesRemoved(i + 1, rangeLast);
+            rangeLast = -1;
+        }
+    }
+    targets.erase(std::remove(targets.begin(), targets.end(), -1),
+                  targets.end());
+
+    this->reorderContentPanes(targets);
+
+    // all remaining panes are in the right order now, the new ones are
+    // inserted in spec order
+    std::vector<ContentPane *> range;
+    for (std::size_t j = 0; j <= panes.size(); j++) {
+        if (j < panes.size() && specPanes.at(j) == nullptr) {
+            const PaneSpec &spec = panes.at(j);
+            ContentPane *cpane = this->createContentPane(spec.header, nullptr);
+            if (spec.content) {
+                cpane->setContentFactory(spec.content);
+            }
+            specPanes.at(j) = cpane;
+            range.push_back(cpane);
+            continue;
+        }
+        if (!range.empty()) {
+            std::size_t rangeFirst = j - range.size();
+            this->attachContentPanes(rangeFirst, range);
+            emit panesInserted(static_cast<int>(rangeFirst),
+                               static_cast<int>(j) - 1);
+            range.clear();
+        }
+    }
+
+    // update the headers of the panes we kept and remember the keys
+    for (std::size_t j = 0; j < panes.size(); j++) {
+        const PaneSpec &spec = panes.at(j);
+        ContentPane *cpane = specPanes.at(j);
+        if (cpane->getHeader() != spec.header) {
+            cpane->setHeader(spec.header);
+        }
+        cpane->d->key = spec.key.isEmpty() ? spec.header : spec.key;
+    }
+
+    this->setUpdatesEnabled(updatesEnabled);
+
+    if (this->d->contentPanes.size() != oldNumberOfPanes) {
+        emit numberOfContentPanesChanged(this->d->contentPanes.size());
+    }
+    this->d->bulkOperations--;
+
+    return true;
+}
+
+int QAccordion::addSection(QString header, std::vector<PaneSpec> panes)
+{
+    QACCORDION_TRACE_SCOPE("QAccordion::addSection");
+    if (this->d->sections.contains(header) ||
+        this->findContentPaneIndex(header) != -1) {
+        this->d->errorString =
+            "Can not add section " + header + " as it already exists";
+        return -1;
+    }
+    // the slash separates the section from the child in a path
+    if (header.contains('/')) {
+        this->d->errorString =
+            "Can not add section " + header + ". Keys must not contain /";
+        return -1;
+    }
+    for (const PaneSpec &spec : panes) {
+        const QString &key = spec.key.isEmpty() ? spec.header : spec.key;
+        if (key.contains('/')) {
+            this->d->errorString = "Can not add section " + header +
+                                   ". Key " + key + " contains /";
+            return -1;
+        }
+    }
+
+    ContentPane *cpane = this->createContentPane(header, nullptr);
+    cpane->d->key = header;
+    // the children are the content of a section
+    cpane->setMaximumHeight(0);
+    this->attachContentPane(this->d->contentPanes.size(), cpane);
+    int index = static_cast<int>(this->d->contentPanes.size() - 1);
+
+    Section &section = this->d->sections[header];
+    section.cpane = cpane;
+    section.panes = std::move(panes);
+    section.expanded = false;
+
+    emit panesInserted(index, index);
+    emit numberOfContentPanesChanged(this->d->contentPanes.size());
+
+    return index;
+}
+
+bool QAccordion::setSectionExpanded(const QString &section, bool expanded)
+{
+    return this->setSectionsExpanded(QStringList(section), expanded);
+}
+
+bool QAccordion::setSectionsExpanded(const QStringList &sections,
+                                     bool expanded)
+{
+    QACCORDION_TRACE_SCOPE("QAccordion::setSectionsExpanded");
+    for (const QString &key : sections) {
+        if (!this->d->sections.contains(key)) {
+            this->d->errorString = "Can not find section " + key;
+            return false;
+        }
+    }
+
+    const std::size_t oldNumberOfPanes = this->d->contentPanes.size();
+    // one layout pass and repaint for all sections
+    const bool updatesEnabled = this->updatesEnabled();
+    this->setUpdatesEnabled(false);
+    this->d->bulkOperations++;
+
+    for (const QString &key : sections) {
+        if (expanded) {
+            this->expandSection(key);
+        } else {
+            this->collapseSection(key);
+        }
+    }
+
+    this->setUpdatesEnabled(updatesEnabled);
+
+    if (this->d->contentPanes.size() != oldNumberOfPanes) {
+        emit numberOfContentPanesChanged(this->d->contentPanes.size());
+    }
+    this->d->bulkOperations--;
+
+    return true;
+}
+
+bool QAccordion::getSectionExpanded(const QString &section) const
+{
+    auto it = this->d->sections.constFind(section);
+    return it != this->d->sections.constEnd() && it->expanded;
+}
+
+QStringList QAccordion::getSections() const
+{
+    return this->d->sections.keys();
+}
+
+ContentPane *QAccordion::getContentPaneByPath(const QString &path)
+{
+    int separator = path.indexOf('/');
+    if (separator == -1) {
+        for (ContentPane *cpane : this->d->contentPanes) {
+            if (this->contentPaneKey(cpane) == path) {
+                return cpane;
+            }
+        }
+        this->d->errorString = "Can not find content pane " + path;
+        return nullptr;
+    }
+
+    auto section = this->d->sections.constFind(path.left(separator));
+    if (section == this->d->sections.constEnd()) {
+        this->d->errorString = "Can not find section " + path.left(separator);
+        return nullptr;
+    }
+    // the content panes of a collapsed section do not exist
+    for (const QPointer<ContentPane> &child : section->children) {
+        if (!child.isNull() && child->d->key == path) {
+            return child;
+        }
+    }
+    this->d->errorString = "Can not find content pane " + path;
+    return nullptr;
+}
+
+bool QAccordion::insertContentPanes(uint index,
+                                    const std::vector<ContentPane *> &panes)
+{
+    QACCORDION_TRACE_SCOPE("QAccordion::insertContentPanes");
+    if (this->checkIndexError(index, true,
+                              "Can not insert content panes at index " +
+                                  QString::number(index) +
+                                  ". Index out of range")) {
+        return false;
+    }
+    QSet<ContentPane *> unique;
+    for (ContentPane *cpane : panes) {
+        if (cpane == nullptr || unique.contains(cpane) ||
+            this->findContentPaneIndex("", nullptr, cpane) != -1) {
+            this->d->errorString =
+                "Can not insert content panes as one of them is invalid or "
+                "already managed by the accordion widget";
+            return false;
+        }
+        unique.insert(cpane);
+    }
+    if (panes.empty()) {
+        return true;
+    }
+
+    this->attachContentPanes(index, panes);
+
+    emit panesInserted(static_cast<int>(index),
+                       static_cast<int>(index + panes.size()) - 1);
+    emit numberOfContentPanesChanged(this->d->contentPanes.size());
+
+    return true;
+}
+
+bool QAccordion::removeContentPanes(bool deleteObject, uint first, uint last)
+{
+    QACCORDION_TRACE_SCOPE("QAccordion::removeContentPanes");
+    if (first > last ||
+        this->checkIndexError(last, false,
+                              "Can not remove content panes up to index " +
+                                  QString::number(last) +
+                                  ". Index out of range")) {
+        return false;
+    }
+
+    std::vector<ContentPane *> removed =
+        this->detachContentPanes(first, last - first + 1);
+    if (deleteObject) {
+        for (ContentPane *cpane : removed) {
+            delete cpane;
+        }
+    }
+
+    emit panesRemoved(static_cast<int>(first), static_cast<int>(last));
+    emit numberOfContentPanesChanged(this->d->contentPanes.size());
+
+    return true;
+}
+
+bool QAccordion::moveContentPanes(uint first, uint last, uint destination)
+{
+    QACCORDION_TRACE_SCOPE("QAccordion::moveContentPanes");
+    if (first > last ||
+        this->checkIndexError(last, false,
+                              "Can not move content panes up to index " +
+                                  QString::number(last) +
+                                  ". Index out of range")) {
+        return false;
+    }
+    std::size_t count = last - first + 1;
+    if (destination + count > this->d->contentPanes.size()) {
+        this->d->errorString = "Can not move content panes to " +
+                               QString::number(destination) +
+                               ". Index out of range";
+        return false;
+    }
+    if (destination == first) {
+        return true;
+    }
+
+    this->relocateContentPanes(first, count, destination);
+
+    emit panesMoved(static_cast<int>(first), static_cast<int>(last),
+                    static_cast<int>(destination));
 
     return true;
 }
@@ -155,14 +567,64 @@ bool QAccordion::moveContentPane(uint currentIndex, uint newIndex)
 ContentPane *QAccordion::getContentPane(uint index)
 {
     try {
-        return this->contentPanes.at(index);
+        return this->d->contentPanes.at(index);
     } catch (const std::out_of_range &ex) {
         qDebug() << Q_FUNC_INFO << "Can not return Content Pane: " << ex.what();
-        this->errorString = "Can not return Content Pane: " + QString(ex.what());
+        this->d->errorString =
+            "Can not return Content Pane: " + QString(ex.what());
         return nullptr;
     }
 }
 
+ContentPane *QAccordion::getContentPane(PaneHandle handle) const
+{
+    ContentPane *const *cpane = this->d->paneSlots.get(handle);
+    return cpane != nullptr ? *cpane : nullptr;
+}
+
+PaneHandle QAccordion::getContentPaneHandle(uint index)
+{
+    if (this->checkIndexError(index, false,
+                              "Can not get handle of content pane at index " +
+                                  QString::number(index) +
+                                  ". Index out of range.")) {
+        return PaneHandle();
+    }
+    return this->d->contentPanes.at(index)->d->handle;
+}
+
+PaneHandle QAccordion::getContentPaneHandle(ContentPane *contentPane) const
+{
+    // the handle stored in the pane is only meaningful for this accordion if
+    // it resolves to the very same pane
+    if (contentPane == nullptr ||
+        this->getContentPane(contentPane->d->handle) != contentPane) {
+        return PaneHandle();
+    }
+    return contentPane->d->handle;
+}
+
+bool QAccordion::isValidContentPaneHandle(PaneHandle handle) const
+{
+    return this->d->paneSlots.contains(handle);
+}
+
+int QAccordion::getContentPaneIndexAt(int y) const
+{
+    return this->d->layout->indexAt(y);
+}
+
+int QAccordion::getContentPanePosition(uint index)
+{
+    if (this->checkIndexError(index, false,
+                              "Can not get position of content pane at index " +
+                                  QString::number(index) +
+                                  ". Index out of range.")) {
+        return -1;
+    }
+    return this->d->layout->itemPosition(static_cast<int>(index));
+}
+
 int QAccordion::getContentPaneIndex(QString header) const
 {
     return this->findContentPaneIndex(std::move(header));
@@ -178,11 +640,20 @@ int QAccordion::getContentPaneIndex(ContentPane *contentPane) const
     return this->findContentPaneIndex("", nullptr, contentPane);
 }
 
+int QAccordion::getContentPaneIndex(PaneHandle handle) const
+{
+    ContentPane *cpane = this->getContentPane(handle);
+    if (cpane == nullptr) {
+        return -1;
+    }
+    return this->d->layout->indexOf(cpane);
+}
+
 void QAccordion::getActiveContentPaneIndex(std::vector<int> &indexVector) const
 {
     // first of all make sure it is empty
     indexVector.clear();
-    std::for_each(this->contentPanes.begin(), this->contentPanes.end(),
+    std::for_each(this->d->contentPanes.begin(), this->d->contentPanes.end(),
                   [&indexVector, this](ContentPane *pane) {
                       if (pane->getActive()) {
                           indexVector.push_back(
@@ -191,50 +662,279 @@ void QAccordion::getActiveContentPaneIndex(std::vector<int> &indexVector) const
                   });
 }
 
-int QAccordion::getNumberOfContentPanes() const { return this->contentPanes.size(); }
+int QAccordion::getNumberOfContentPanes() const
+{
+    return this->d->contentPanes.size();
+}
+
+bool QAccordion::setActive(uint first, uint last, bool active)
+{
+    QACCORDION_TRACE_SCOPE("QAccordion::setActive");
+    if (first > last) {
+        this->d->errorString = "Can not change state of content panes " +
+                               QString::number(first) + " to " +
+                               QString::number(last) + ". Invalid range.";
+        return false;
+    }
+    if (this->checkIndexError(last, false,
+                              "Can not change state of content panes " +
+                                  QString::number(first) + " to " +
+                                  QString::number(last) +
+                                  ". Index out of range.")) {
+        return false;
+    }
+    if (active && !this->d->multiActive && last > first) {
+        this->d->errorString = "Can not open several content panes as "
+                               "multiActive is false";
+        return false;
+    }
+
+    std::vector<bool> states;
+    states.reserve(this->d->contentPanes.size());
+    for (ContentPane *cpane : this->d->contentPanes) {
+        states.push_back(active && !this->d->multiActive ? false
+                                                         : cpane->getActive());
+    }
+    for (uint i = first; i <= last; i++) {
+        states.at(i) = active;
+    }
+    if (!this->d->collapsible &&
+        std::none_of(states.begin(), states.end(),
+                     [](bool state) { return state; })) {
+        for (uint i = first; i <= last; i++) {
+            if (this->d->contentPanes.at(i)->getActive()) {
+                states.at(i) = true;
+                break;
+            }
+        }
+    }
+    this->applyActiveStates(states);
+    return true;
+}
+
+bool QAccordion::expandAll()
+{
+    if (this->d->contentPanes.empty()) {
+        return true;
+    }
+    return this->setActive(0, this->d->contentPanes.size() - 1, true);
+}
 
-void QAccordion::setMultiActive(bool status) { this->multiActive = status; }
+bool QAccordion::collapseAll()
+{
+    if (this->d->contentPanes.empty()) {
+        return true;
+    }
+    return this->setActive(0, this->d->contentPanes.size() - 1, false);
+}
 
-bool QAccordion::getMultiActive() const { return this->multiActive; }
+void QAccordion::setMultiActive(bool status) { this->d->multiActive = status; }
 
-void QAccordion::setCollapsible(bool status) { this->collapsible = status; }
+bool QAccordion::getMultiActive() const { return this->d->multiActive; }
 
-bool QAccordion::getCollapsible() const { return this->collapsible; }
+void QAccordion::setCollapsible(bool status) { this->d->collapsible = status; }
 
-QString QAccordion::getError() { return this->errorString; }
+bool QAccordion::getCollapsible() const { return this->d->collapsible; }
+
+void QAccordion::setAnimationPolicy(QAccordion::ANIMATION policy)
+{
+    this->d->animationPolicy = policy;
+    this->d->frameTime = -1;
+    if (this->d->animationPolicy == ANIMATION::INSTANT) {
+        for (ContentPane *cpane : this->d->contentPanes) {
+            cpane->releaseAnimations();
+        }
+    }
+}
+
+QAccordion::ANIMATION QAccordion::getAnimationPolicy() const
+{
+    return this->d->animationPolicy;
+}
+
+void QAccordion::setStickyHeaders(bool sticky)
+{
+    if (sticky == (this->d->stickyHeader != nullptr)) {
+        return;
+    }
+    if (sticky) {
+        this->d->stickyHeader = new StickyHeader(this);
+        this->d->stickyHeader->hide();
+        this->d->stickyHeaderLowered = true;
+        this->trackScrollArea();
+        this->updateStickyHeader();
+    } else {
+        delete this->d->stickyHeader;
+        this->d->stickyHeader = nullptr;
+        this->trackScrollArea();
+    }
+}
+
+bool QAccordion::getStickyHeaders() const
+{
+    return this->d->stickyHeader != nullptr;
+}
+
+void QAccordion::setUsageTracking(bool enable)
+{
+    this->d->usageTracking = enable;
+    if (this->d->usageTracking) {
+        this->schedulePrefetch();
+    } else {
+        this->d->prefetchTimer.stop();
+    }
+}
+
+bool QAccordion::getUsageTracking() const { return this->d->usageTracking; }
+
+void QAccordion::setPrefetchCount(uint count)
+{
+    this->d->prefetchCount = count;
+    this->schedulePrefetch();
+}
+
+uint QAccordion::getPrefetchCount() const { return this->d->prefetchCount; }
+
+QByteArray QAccordion::saveUsageStatistics() const
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_2);
+    stream << USAGE_STATISTICS_MAGIC << USAGE_STATISTICS_VERSION
+           << static_cast<quint32>(this->d->paneUsage.size());
+    for (auto it = this->d->paneUsage.cbegin(); it != this->d->paneUsage.cend();
+         ++it) {
+        stream << it.key() << it->opens << it->lastOpened;
+    }
+    return data;
+}
+
+bool QAccordion::restoreUsageStatistics(const QByteArray &data)
+{
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_5_2);
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 count = 0;
+    stream >> magic >> version >> count;
+    if (magic != USAGE_STATISTICS_MAGIC ||
+        version != USAGE_STATISTICS_VERSION) {
+        this->d->errorString =
+            "Can not restore usage statistics, unknown format";
+        return false;
+    }
+
+    QHash<QString, PaneUsage> usage;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok;
+         i++) {
+        QString key;
+        PaneUsage paneUsage{};
+        stream >> key >> paneUsage.opens >> paneUsage.lastOpened;
+        usage.insert(key, paneUsage);
+    }
+    if (stream.status() != QDataStream::Ok) {
+        this->d->errorString = "Can not restore usage statistics, data is "
+                               "truncated or corrupt";
+        return false;
+    }
+    this->d->paneUsage = std::move(usage);
+    this->schedulePrefetch();
+    return true;
+}
+
+void QAccordion::clearUsageStatistics()
+{
+    this->d->paneUsage.clear();
+    this->d->prefetchTimer.stop();
+}
+
+void QAccordion::setHeightCache(HeightCache *cache)
+{
+    this->d->heightCache = cache;
+    for (ContentPane *cpane : this->d->contentPanes) {
+        cpane->d->heightCache = this->d->heightCache;
+    }
+}
+
+HeightCache *QAccordion::getHeightCache() const { return this->d->heightCache; }
+
+QString QAccordion::getError() { return this->d->errorString; }
+
+void QAccordion::setHeaderStyle(const HeaderStyle &style)
+{
+    this->d->headerStyle = std::make_shared<const HeaderStyle>(style);
+    this->updateHeaderStyle();
+}
+
+HeaderStyle QAccordion::getHeaderStyle() const
+{
+    return *this->d->headerStyle;
+}
+
+MemoryFootprint QAccordion::getMemoryFootprint() const
+{
+    MemoryFootprint footprint;
+    QSet<qint64> pixmapKeys;
+    for (ContentPane *cpane : this->d->contentPanes) {
+        cpane->addMemoryFootprint(footprint, pixmapKeys);
+    }
+
+    footprint.widgets += MemoryFootprint::estimateObject(this);
+    // layout items plus height and prefix sum of every pane
+    footprint.layouts +=
+        MemoryFootprint::estimateObject(this->layout()) +
+        this->d->contentPanes.size() * (sizeof(QLayoutItem *) + 2 * sizeof(int));
+    footprint.other += sizeof(QAccordion) - sizeof(QWidget) +
+                       sizeof(QAccordionPrivate) +
+                       this->d->contentPanes.capacity() * sizeof(ContentPane *) +
+                       this->d->paneSlots.memoryUsage();
+    footprint.strings += MemoryFootprint::estimateString(this->d->errorString);
+    for (auto it = this->d->paneUsage.cbegin(); it != this->d->paneUsage.cend();
+         ++it) {
+        footprint.other += sizeof(PaneUsage) + sizeof(QString) + sizeof(void *);
+        footprint.strings += MemoryFootprint::estimateString(it.key());
+    }
+    for (auto it = this->d->sections.cbegin(); it != this->d->sections.cend();
+         ++it) {
+        footprint.other +=
+            sizeof(Section) + sizeof(QString) + sizeof(void *) +
+            it->panes.capacity() * sizeof(PaneSpec) +
+            it->children.capacity() * sizeof(QPointer<ContentPane>);
+        footprint.strings += MemoryFootprint::estimateString(it.key());
+        for (const PaneSpec &spec : it->panes) {
+            footprint.strings += MemoryFootprint::estimateString(spec.key) +
+                                 MemoryFootprint::estimateString(spec.header);
+        }
+    }
+    return footprint;
+}
 
 int QAccordion::internalAddContentPane(QString header, QFrame *cframe,
                                        ContentPane *cpane)
 {
+    QACCORDION_TRACE_SCOPE("QAccordion::addContentPane");
     if (this->findContentPaneIndex(header, cframe, cpane) != -1) {
-        this->errorString = "Can not add content pane as it already exists";
+        this->d->errorString = "Can not add content pane as it already exists";
         return -1;
     }
 
     if (cpane == nullptr) {
-        if (cframe != nullptr) {
-            cpane = new ContentPane(std::move(header), cframe);
-        } else {
-            cpane = new ContentPane(std::move(header));
-        }
+        cpane = this->createContentPane(std::move(header), cframe);
     }
-    dynamic_cast<QVBoxLayout *>(this->layout())
-        ->insertWidget(this->layout()->count() - 1, cpane);
-    this->contentPanes.push_back(cpane);
-
-    // manage the clicked signal in a lambda expression
-    QObject::connect(cpane, &ContentPane::clicked,
-                     [this, cpane]() { this->handleClickedSignal(cpane); });
+    this->attachContentPane(this->d->contentPanes.size(), cpane);
+    int index = static_cast<int>(this->d->contentPanes.size() - 1);
 
-    emit numberOfContentPanesChanged(this->contentPanes.size());
+    emit panesInserted(index, index);
+    emit numberOfContentPanesChanged(this->d->contentPanes.size());
 
-    return static_cast<int>(this->contentPanes.size() - 1);
+    return index;
 }
 
 bool QAccordion::internalInsertContentPane(uint index, QString header,
                                            QFrame *contentFrame,
                                            ContentPane *cpane)
 {
+    QACCORDION_TRACE_SCOPE("QAccordion::insertContentPane");
     if (this->checkIndexError(index, true,
                               "Can not insert Content Pane at index " +
                                   QString::number(index) +
@@ -247,22 +947,13 @@ bool QAccordion::internalInsertContentPane(uint index, QString header,
     }
 
     if (cpane == nullptr) {
-        if (contentFrame != nullptr) {
-            cpane = new ContentPane(std::move(header), contentFrame);
-        } else {
-            cpane = new ContentPane(std::move(header));
-        }
+        cpane = this->createContentPane(std::move(header), contentFrame);
     }
 
-    dynamic_cast<QVBoxLayout *>(this->layout())->insertWidget(index, cpane);
+    this->attachContentPane(index, cpane);
 
-    this->contentPanes.insert(this->contentPanes.begin() + index, cpane);
-
-    // manage the clicked signal in a lambda expression
-    QObject::connect(cpane, &ContentPane::clicked,
-                     [this, cpane]() { this->handleClickedSignal(cpane); });
-
-    emit numberOfContentPanesChanged(this->contentPanes.size());
+    emit panesInserted(index, index);
+    emit numberOfContentPanesChanged(this->d->contentPanes.size());
 
     return true;
 }
@@ -271,6 +962,7 @@ bool QAccordion::internalRemoveContentPane(bool deleteOject, int index,
                                            QString name, QFrame *contentFrame,
                                            ContentPane *cpane)
 {
+    QACCORDION_TRACE_SCOPE("QAccordion::removeContentPane");
     if (index != -1 &&
         this->checkIndexError(index, false,
                               "Can not remove content pane at index " +
@@ -282,29 +974,256 @@ bool QAccordion::internalRemoveContentPane(bool deleteOject, int index,
     if (index == -1) {
         index = this->findContentPaneIndex(std::move(name), contentFrame, cpane);
         if (index == -1) {
-            this->errorString =
+            this->d->errorString =
                 "Can not remove content pane as it is not part "
                 "of the accordion widget";
             return false;
         }
     }
 
-    dynamic_cast<QVBoxLayout *>(this->layout())
-        ->removeWidget(this->contentPanes.at(index));
+    ContentPane *removed = this->detachContentPane(index);
 
     // only delete the object if user wants to.
     if (deleteOject) {
-        delete this->contentPanes.at(index);
-        this->contentPanes.at(index) = nullptr;
+        delete removed;
     }
 
-    this->contentPanes.erase(this->contentPanes.begin() + index);
-
-    emit numberOfContentPanesChanged(this->contentPanes.size());
+    emit panesRemoved(index, index);
+    emit numberOfContentPanesChanged(this->d->contentPanes.size());
 
     return true;
 }
 
+bool QAccordion::isSection(ContentPane *cpane) const
+{
+    if (this->d->sections.isEmpty()) {
+        return false;
+    }
+    auto it = this->d->sections.constFind(this->contentPaneKey(cpane));
+    return it != this->d->sections.constEnd() && it->cpane == cpane;
+}
+
+void QAccordion::expandSection(const QString &key)
+{
+    Section &section = this->d->sections[key];
+    if (section.expanded || section.cpane.isNull()) {
+        return;
+    }
+    section.expanded = true;
+    section.cpane->d->header->setIcon(section.cpane->d->headerIconActive);
+    if (section.panes.empty()) {
+        return;
+    }
+
+    int first = this->findContentPaneIndex("", nullptr, section.cpane) + 1;
+    std::vector<ContentPane *> panes;
+    panes.reserve(section.panes.size());
+    section.children.reserve(section.panes.size());
+    for (const PaneSpec &spec : section.panes) {
+        ContentPane *cpane = this->createContentPane(spec.header, nullptr);
+        if (spec.content) {
+            cpane->setContentFactory(spec.content);
+        }
+        cpane->d->key =
+            key + "/" + (spec.key.isEmpty() ? spec.header : spec.key);
+        cpane->setContentsMargins(SECTION_INDENT, 0, 0, 0);
+        panes.push_back(cpane);
+        section.children.emplace_back(cpane);
+    }
+    // one layout operation for all children
+    this->attachContentPanes(first, panes);
+    emit panesInserted(first,
+                       first + static_cast<int>(section.panes.size()) - 1);
+}
+
+void QAccordion::collapseSection(const QString &key)
+{
+    Section &section = this->d->sections[key];
+    if (!section.expanded || section.cpane.isNull()) {
+        return;
+    }
+    section.expanded = false;
+    section.cpane->d->header->setIcon(section.cpane->d->headerIconInActive);
+
+    QSet<ContentPane *> children;
+    for (const QPointer<ContentPane> &child : section.children) {
+        if (!child.isNull()) {
+            children.insert(child);
+        }
+    }
+    section.children.clear();
+
+    // remove from the back so every contiguous range is reported once with
+    // indexes that are valid for the observers
+    int rangeLast = -1;
+    for (int i = static_cast<int>(this->d->contentPanes.size()) - 1;
+         i >= -1 && (!children.isEmpty() || rangeLast != -1); i--) {
+        if (i >= 0 && children.remove(this->d->contentPanes.at(i))) {
+            if (rangeLast == -1) {
+                rangeLast = i;
+            }
+            continue;
+        }
+        if (rangeLast != -1) {
+            for (ContentPane *cpane :
+                 this->detachContentPanes(i + 1, rangeLast - i)) {
+                delete cpane;
+            }
+            emit panesRemoved(i + 1, rangeLast);
+            rangeLast = -1;
+        }
+    }
+}
+
+void QAccordion::attachContentPane(std::size_t index, ContentPane *cpane)
+{
+    this->attachContentPanes(index, {cpane});
+}
+
+void QAccordion::attachContentPanes(std::size_t index,
+                                    const std::vector<ContentPane *> &panes)
+{
+    // one layout operation for the whole range
+    this->d->layout->insertWidgets(
+        static_cast<int>(index),
+        std::vector<QWidget *>(panes.begin(), panes.end()));
+    this->d->contentPanes.insert(this->d->contentPanes.begin() + index,
+                                 panes.begin(), panes.end());
+    this->d->stickyHeaderLowered = true;
+
+    for (ContentPane *cpane : panes) {
+        cpane->d->handle = this->d->paneSlots.insert(cpane);
+        cpane->d->heightCache = this->d->heightCache;
+        cpane->d->header->setHeaderStyle(this->d->headerStyle);
+        // the pane is laid out now, an outer pane has to know its height
+        cpane->containerHeightChanged();
+
+        // manage the clicked signal in a lambda expression
+        QObject::connect(
+            cpane, &ContentPane::clicked, this,
+            [this, cpane]() { this->handleClickedSignal(cpane); });
+        // learn how long animation frames take
+        QObject::connect(cpane, &ContentPane::isActive, this,
+                         [this, cpane]() {
+                             this->updateFrameTime(cpane);
+                             // the next content is built once the animation
+                             // is done
+                             this->schedulePrefetch();
+                         });
+        QObject::connect(cpane, &ContentPane::isInactive, this,
+                         [this, cpane]() { this->updateFrameTime(cpane); });
+    }
+}
+
+ContentPane *QAccordion::detachContentPane(std::size_t index)
+{
+    return this->detachContentPanes(index, 1).front();
+}
+
+std::vector<ContentPane *> QAccordion::detachContentPanes(std::size_t index,
+                                                          std::size_t count)
+{
+    std::vector<ContentPane *> panes(
+        this->d->contentPanes.begin() + index,
+        this->d->contentPanes.begin() + index + count);
+    // QLayout::removeWidget() searches the whole layout
+    this->d->layout->removeWidgets(static_cast<int>(index),
+                                   static_cast<int>(count));
+    auto first = this->d->contentPanes.begin() + index;
+    this->d->contentPanes.erase(first, first + count);
+
+    for (ContentPane *cpane : panes) {
+        // the children of a removed section stay as ordinary content panes
+        if (this->isSection(cpane)) {
+            this->d->sections.remove(this->contentPaneKey(cpane));
+        }
+        this->d->paneSlots.erase(cpane->d->handle);
+        cpane->d->handle = PaneHandle();
+        cpane->d->heightCache = nullptr;
+        cpane->d->header->setHeaderStyle(nullptr);
+        // the height does not count for an outer pane any more
+        cpane->containerHeightChanged();
+        if (this->d->hoveredHeader == cpane->d->header) {
+            this->setHoveredHeader(nullptr);
+        }
+        if (this->d->stickyHeader != nullptr &&
+            this->d->stickyHeader->getHeader() == cpane->d->header) {
+            this->d->stickyHeader->hide();
+        }
+
+        // a pane that was not deleted may be added to another accordion
+        QObject::disconnect(cpane, nullptr, this, nullptr);
+    }
+
+    return panes;
+}
+
+void QAccordion::relocateContentPane(std::size_t currentIndex,
+                                     std::size_t newIndex)
+{
+    this->relocateContentPanes(currentIndex, 1, newIndex);
+}
+
+void QAccordion::relocateContentPanes(std::size_t index, std::size_t count,
+                                      std::size_t destination)
+{
+    std::vector<ContentPane *> panes(
+        this->d->contentPanes.begin() + index,
+        this->d->contentPanes.begin() + index + count);
+
+    // take the widgets out of the layout and insert them at the new position
+    AccordionLayout *layout = this->d->layout;
+    layout->removeWidgets(static_cast<int>(index), static_cast<int>(count));
+    layout->insertWidgets(
+        static_cast<int>(destination),
+        std::vector<QWidget *>(panes.begin(), panes.end()));
+
+    // keep our vector synchronized
+    auto first = this->d->contentPanes.begin() + index;
+    this->d->contentPanes.erase(first, first + count);
+    this->d->contentPanes.insert(this->d->contentPanes.begin() + destination,
+                                 panes.begin(), panes.end());
+}
+
+void QAccordion::reorderContentPanes(const std::vector<int> &targets)
+{
+    // content panes that are part of the longest increasing subsequence of
+    // targets are already in the right order. only the others are moved,
+    // each one directly behind its predecessor in target order.
+    std::vector<bool> inOrder = longestIncreasingSubsequence(targets);
+    std::vector<ContentPane *> panes = this->d->contentPanes;
+    std::vector<std::size_t> order(panes.size());
+    for (std::size_t i = 0; i < order.size(); i++) {
+        order.at(i) = i;
+    }
+    std::sort(order.begin(), order.end(),
+              [&targets](std::size_t a, std::size_t b) {
+                  return targets.at(a) < targets.at(b);
+              });
+
+    ContentPane *predecessor = nullptr;
+    for (std::size_t i : order) {
+        ContentPane *cpane = panes.at(i);
+        if (!inOrder.at(i)) {
+            int from = this->d->layout->indexOf(cpane);
+            int to = 0;
+            if (predecessor != nullptr) {
+                int predecessorIndex = this->d->layout->indexOf(predecessor);
+                to = from < predecessorIndex ? predecessorIndex
+                                             : predecessorIndex + 1;
+            }
+            this->relocateContentPane(from, to);
+            emit panesMoved(from, from, to);
+        }
+        predecessor = cpane;
+    }
+}
+
+QString QAccordion::contentPaneKey(ContentPane *cpane) const
+{
+    return cpane->d->key.isEmpty() ? cpane->getHeader() : cpane->d->key;
+}
+
 int QAccordion::findContentPaneIndex(QString name, QFrame *cframe,
                                      ContentPane *cpane) const
 {
@@ -313,30 +1232,32 @@ int QAccordion::findContentPaneIndex(QString name, QFrame *cframe,
     int index = -1;
     if (name != "") {
         auto result = std::find_if(
-            this->contentPanes.begin(), this->contentPanes.end(),
+            this->d->contentPanes.begin(), this->d->contentPanes.end(),
             [&name](ContentPane *pane) { return pane->getHeader() == name; });
-        if (result != std::end(this->contentPanes)) {
+        if (result != std::end(this->d->contentPanes)) {
             // get the index by subtracting begin iterator from result
             // iterator
             // TODO: Is this cast really necessary?
-            index = static_cast<int>(result - this->contentPanes.begin());
+            index = static_cast<int>(result - this->d->contentPanes.begin());
         }
     }
     if (cframe != nullptr) {
-        auto result =
-            std::find_if(this->contentPanes.begin(), this->contentPanes.end(),
-                         [cframe](ContentPane *cpane) {
-                             return cpane->getContentFrame() == cframe;
-                         });
-        if (result != std::end(this->contentPanes)) {
-            index = static_cast<int>(result - this->contentPanes.begin());
+        auto result = std::find_if(this->d->contentPanes.begin(),
+                                   this->d->contentPanes.end(),
+                                   [cframe](ContentPane *cpane) {
+                                       return cpane->getContentFrame() ==
+                                              cframe;
+                                   });
+        if (result != std::end(this->d->contentPanes)) {
+            index = static_cast<int>(result - this->d->contentPanes.begin());
         }
     }
     if (cpane != nullptr) {
-        auto result = std::find(this->contentPanes.begin(),
-                                this->contentPanes.end(), cpane);
-        if (result != std::end(this->contentPanes)) {
-            index = static_cast<int>(result - this->contentPanes.begin());
+        // the layout holds the content panes in the same order and knows the
+        // index of every widget
+        int result = this->d->layout->indexOf(cpane);
+        if (result != -1) {
+            index = result;
         }
     }
     return index;
@@ -353,15 +1274,15 @@ bool QAccordion::checkIndexError(uint index, bool sizeIndexAllowed,
     // Update, I removed the 0 exclusion in the second if statement. Really a
     // fix??
     if (sizeIndexAllowed) {
-        if (index != 0 && index > this->contentPanes.size()) {
+        if (index != 0 && index > this->d->contentPanes.size()) {
             qDebug() << Q_FUNC_INFO << errMessage;
-            this->errorString = errMessage;
+            this->d->errorString = errMessage;
             return true;
         }
     } else {
-        if (index >= this->contentPanes.size()) {
+        if (index >= this->d->contentPanes.size()) {
             qDebug() << Q_FUNC_INFO << errMessage;
-            this->errorString = errMessage;
+            this->d->errorString = errMessage;
             return true;
         }
     }
@@ -370,55 +1291,463 @@ bool QAccordion::checkIndexError(uint index, bool sizeIndexAllowed,
 
 void QAccordion::handleClickedSignal(ContentPane *cpane)
 {
+    QACCORDION_TRACE_SCOPE("QAccordion::handleClickedSignal");
+    if (this->isSection(cpane)) {
+        QString key = this->contentPaneKey(cpane);
+        this->setSectionExpanded(key, !this->getSectionExpanded(key));
+        return;
+    }
     // if the clicked content pane is open we simply close it and return
     if (cpane->getActive()) {
         // if collapsible and multiActive are false we are not allowed to close
         // this pane
-        if (!this->collapsible && !this->multiActive) {
+        if (!this->d->collapsible && !this->d->multiActive) {
             return;
         }
         // when multiActive is true we have to check if there is any other open
         // cpane. if so we can close this one
         std::vector<int> activePanes;
-        if (!this->collapsible) {
+        if (!this->d->collapsible) {
             this->getActiveContentPaneIndex(activePanes);
             if (activePanes.size() == 1) {
                 return;  // only one active --> good bye :)
             }
         }
-        cpane->closeContentPane();
+        this->setContentPaneActive(
+            this->findContentPaneIndex("", nullptr, cpane), false);
         return;
     }
     // if it is not open we will open it and search our vector for other
     // panes that are already open.
     // TODO: Is it really necessary to search for more than one open cpane?
     if (!cpane->getActive()) {
+        int index = this->findContentPaneIndex("", nullptr, cpane);
         // check if multiActive is allowed
         if (!this->getMultiActive()) {
-            std::for_each(this->contentPanes.begin(), this->contentPanes.end(),
-                          [](ContentPane *pane) {
-                              if (pane->getActive()) {
-                                  pane->closeContentPane();
-                              }
-                          });
+            for (std::size_t i = 0; i < this->d->contentPanes.size(); i++) {
+                this->setContentPaneActive(static_cast<int>(i), false);
+            }
+        }
+        this->setContentPaneActive(index, true);
+    }
+}
+
+void QAccordion::setContentPaneActive(int index, bool active)
+{
+    // a pane must not be moved by two animations
+    this->finishBulkTransition();
+    ContentPane *cpane = this->d->contentPanes.at(index);
+    // sections expand instead of opening
+    if (cpane->getActive() == active || this->isSection(cpane)) {
+        return;
+    }
+    cpane->setAnimated(this->animationsEnabled());
+    if (active) {
+        if (this->d->bulkOperations == 0) {
+            this->recordUsage(cpane);
         }
         cpane->openContentPane();
+    } else {
+        cpane->closeContentPane();
+    }
+    emit paneActiveChanged(index, active);
+}
+
+void QAccordion::applyActiveStates(const std::vector<bool> &states)
+{
+    this->finishBulkTransition();
+    std::vector<int> changed;
+    for (std::size_t i = 0; i < this->d->contentPanes.size(); i++) {
+        ContentPane *cpane = this->d->contentPanes.at(i);
+        if (cpane->getActive() != states.at(i) && !this->isSection(cpane)) {
+            changed.push_back(static_cast<int>(i));
+        }
+    }
+    if (changed.size() <= 1) {
+        for (int index : changed) {
+            this->setContentPaneActive(index, states.at(index));
+        }
+        return;
+    }
+
+    // AUTO never animates bulk operations
+    this->d->bulkOperations++;
+    const bool updatesEnabled = this->updatesEnabled();
+    this->setUpdatesEnabled(false);
+    if (this->animationsEnabled()) {
+        this->startBulkTransition(changed, states);
+    } else {
+        for (int index : changed) {
+            this->setContentPaneActive(index, states.at(index));
+        }
+    }
+    this->setUpdatesEnabled(updatesEnabled);
+    this->d->bulkOperations--;
+}
+
+void QAccordion::startBulkTransition(const std::vector<int> &changed,
+                                     const std::vector<bool> &states)
+{
+    this->d->bulkTransition.reserve(changed.size());
+    for (int index : changed) {
+        ContentPane *cpane = this->d->contentPanes.at(index);
+        int from = cpane->d->container->maximumHeight();
+        cpane->setActiveState(states.at(index));
+        int to = states.at(index) ? cpane->getOpenHeight() : 0;
+        this->d->bulkTransition.push_back({cpane, from, to});
+        emit paneActiveChanged(index, states.at(index));
+    }
+
+    if (!this->d->bulkAnimation) {
+        this->d->bulkAnimation = std::make_unique<QVariantAnimation>();
+        this->d->bulkAnimation->setStartValue(0.0);
+        this->d->bulkAnimation->setEndValue(1.0);
+        this->d->bulkAnimation->setEasingCurve(
+            QEasingCurve(QEasingCurve::Type::Linear));
+        QObject::connect(this->d->bulkAnimation.get(),
+                         &QVariantAnimation::valueChanged, this,
+                         [this](const QVariant &value) {
+                             this->stepBulkTransition(value.toDouble());
+                         });
+        QObject::connect(this->d->bulkAnimation.get(),
+                         &QVariantAnimation::finished, this,
+                         &QAccordion::finishBulkTransition);
+    }
+    // one animation for all panes, every frame is a single layout pass
+    this->d->bulkAnimation->setDuration(static_cast<int>(
+        this->d->contentPanes.at(changed.front())->getAnimationDuration()));
+    this->d->bulkAnimation->start();
+}
+
+void QAccordion::stepBulkTransition(double progress)
+{
+    QACCORDION_TRACE_SCOPE("QAccordion::stepBulkTransition");
+    for (const PaneTransition &transition : this->d->bulkTransition) {
+        if (!transition.cpane.isNull()) {
+            transition.cpane->setContainerHeight(
+                transition.from +
+                static_cast<int>((transition.to - transition.from) * progress));
+        }
+    }
+}
+
+void QAccordion::finishBulkTransition()
+{
+    if (this->d->bulkTransition.empty()) {
+        return;
+    }
+    if (this->d->bulkAnimation->state() == QAbstractAnimation::Running) {
+        this->d->bulkAnimation->stop();
+    }
+    this->stepBulkTransition(1.0);
+    // observers may change the accordion
+    std::vector<PaneTransition> transitions =
+        std::move(this->d->bulkTransition);
+    this->d->bulkTransition.clear();
+    for (const PaneTransition &transition : transitions) {
+        if (!transition.cpane.isNull()) {
+            transition.cpane->emitActiveState();
+        }
+    }
+}
+
+bool QAccordion::animationsEnabled() const
+{
+    switch (this->d->animationPolicy) {
+    case ANIMATION::ANIMATED:
+        return true;
+    case ANIMATION::INSTANT:
+        return false;
+    default:
+        break;
+    }
+    return this->d->bulkOperations == 0 &&
+           this->d->contentPanes.size() <= AUTO_ANIMATION_MAX_PANES &&
+           this->currentFrameTime() <= AUTO_ANIMATION_MAX_FRAME_TIME;
+}
+
+void QAccordion::updateFrameTime(ContentPane *cpane)
+{
+    int paneFrameTime = cpane->getFrameTime();
+    if (paneFrameTime < 0) {
+        return;
+    }
+    // moving average so a single slow frame does not switch off animations
+    int frameTime = this->currentFrameTime();
+    this->d->frameTime = frameTime < 0 ? paneFrameTime
+                                       : (3 * frameTime + paneFrameTime) / 4;
+    this->d->frameTimeAge.start();
+}
+
+int QAccordion::currentFrameTime() const
+{
+    if (this->d->frameTime < 0) {
+        return -1;
+    }
+    // without animations there are no new measurements, so an old value must
+    // not disable them forever
+    qint64 halvings =
+        this->d->frameTimeAge.elapsed() / AUTO_ANIMATION_FRAME_TIME_HALF_LIFE;
+    return halvings >= 31 ? 0 : this->d->frameTime >> halvings;
+}
+
+void QAccordion::updateHeaderStyle()
+{
+    QACCORDION_TRACE_SCOPE("QAccordion::updateHeaderStyle");
+    // headers only repaint, nothing has to be parsed or polished
+    for (ContentPane *cpane : this->d->contentPanes) {
+        cpane->d->header->setHeaderStyle(this->d->headerStyle);
+    }
+    if (this->d->stickyHeader != nullptr) {
+        this->d->stickyHeader->invalidate();
+    }
+}
+
+void QAccordion::updateHoveredHeader(const QPoint &pos)
+{
+    ClickableFrame *header = nullptr;
+    int index = this->d->layout->indexAt(pos.y());
+    // the sticky header covers the panes below it
+    if (this->d->stickyHeader != nullptr && this->d->stickyHeader->isVisible() &&
+        this->d->stickyHeader->geometry().contains(pos)) {
+        index = -1;
+    }
+    if (index >= 0) {
+        ContentPane *cpane = this->d->contentPanes.at(index);
+        QRect headerRect(cpane->mapTo(this, cpane->d->header->pos()),
+                         cpane->d->header->size());
+        if (headerRect.contains(pos) &&
+            cpane->d->header->getTrigger() != ClickableFrame::TRIGGER::NONE) {
+            header = cpane->d->header;
+        }
+    }
+    this->setHoveredHeader(header);
+}
+
+void QAccordion::setHoveredHeader(ClickableFrame *header)
+{
+    if (this->d->hoveredHeader == header) {
+        return;
+    }
+    if (!this->d->hoveredHeader.isNull()) {
+        this->d->hoveredHeader->setHovered(false);
+    }
+    this->d->hoveredHeader = header;
+    if (header != nullptr) {
+        header->setHovered(true);
+    }
+}
+
+void QAccordion::updateStickyHeader()
+{
+    if (this->d->stickyHeader == nullptr) {
+        return;
+    }
+    QACCORDION_TRACE_SCOPE("QAccordion::updateStickyHeader");
+    AccordionLayout *layout = this->d->layout;
+    // the part above the viewport has a negative position in it. the
+    // accordion may be nested in other widgets inside the scroll area.
+    int top = 0;
+    QAbstractScrollArea *scrollArea = this->d->scrollArea;
+    if (scrollArea != nullptr && scrollArea->viewport()->isAncestorOf(this)) {
+        top = std::max(0, -this->mapTo(scrollArea->viewport(), QPoint()).y());
+    } else if (this->isVisible()) {
+        QRegion visible = this->visibleRegion();
+        top = visible.isEmpty() ? 0 : visible.boundingRect().top();
+    }
+    int index = top > 0 ? layout->indexAt(top) : -1;
+    // nothing to do if the header of the top pane is visible anyway
+    if (index < 0 || layout->itemPosition(index) >= top) {
+        this->d->stickyHeader->hide();
+        return;
+    }
+
+    ContentPane *cpane = this->d->contentPanes.at(index);
+    ClickableFrame *header = cpane->d->header;
+    this->d->stickyHeader->setHeader(header);
+    // the header of the next pane pushes the sticky header out
+    int bottom = layout->itemPosition(index) + layout->itemHeight(index);
+    int y = std::min(top, bottom - header->height());
+    this->d->stickyHeader->setGeometry(cpane->x() + header->x(), y,
+                                       header->width(), header->height());
+    if (this->d->stickyHeaderLowered) {
+        this->d->stickyHeader->raise();
+        this->d->stickyHeaderLowered = false;
+    }
+    this->d->stickyHeader->show();
+}
+
+void QAccordion::trackScrollArea()
+{
+    QAbstractScrollArea *scrollArea = nullptr;
+    if (this->d->stickyHeader != nullptr) {
+        for (QWidget *widget = this->parentWidget(); widget != nullptr;
+             widget = widget->parentWidget()) {
+            scrollArea = qobject_cast<QAbstractScrollArea *>(widget);
+            // scroll bars and corner widgets are children as well
+            if (scrollArea != nullptr &&
+                scrollArea->viewport()->isAncestorOf(this)) {
+                break;
+            }
+            scrollArea = nullptr;
+        }
+    }
+    if (scrollArea == this->d->scrollArea) {
+        return;
+    }
+    QObject::disconnect(this->d->scrollConnection);
+    this->d->scrollArea = scrollArea;
+    if (scrollArea != nullptr) {
+        // a nested accordion does not move when the scroll area scrolls
+        this->d->scrollConnection = QObject::connect(
+            scrollArea->verticalScrollBar(), &QScrollBar::valueChanged, this,
+            [this]() { this->updateStickyHeader(); });
     }
 }
 
+void QAccordion::recordUsage(ContentPane *cpane)
+{
+    if (!this->d->usageTracking) {
+        return;
+    }
+    PaneUsage &usage = this->d->paneUsage[this->contentPaneKey(cpane)];
+    usage.opens++;
+    usage.lastOpened = QDateTime::currentMSecsSinceEpoch();
+}
+
+void QAccordion::schedulePrefetch()
+{
+    if (this->d->usageTracking && this->d->prefetchCount > 0 &&
+        !this->d->paneUsage.isEmpty()) {
+        this->d->prefetchTimer.start();
+    }
+}
+
+void QAccordion::prefetchContent()
+{
+    // a running animation must not be interrupted, finishing it schedules
+    // the next prefetch
+    if (!this->d->bulkTransition.empty()) {
+        return;
+    }
+    QACCORDION_TRACE_SCOPE("QAccordion::prefetchContent");
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    std::vector<std::pair<double, ContentPane *>> candidates;
+    for (ContentPane *cpane : this->d->contentPanes) {
+        auto it = this->d->paneUsage.constFind(this->contentPaneKey(cpane));
+        if (it == this->d->paneUsage.cend()) {
+            continue;
+        }
+        double days =
+            static_cast<double>(std::max<qint64>(now - it->lastOpened, 0)) /
+            MSECS_PER_DAY;
+        candidates.emplace_back(it->opens / (days + 1.0), cpane);
+    }
+
+    // panes that have been built already keep their rank
+    std::size_t count =
+        std::min<std::size_t>(this->d->prefetchCount, candidates.size());
+    std::partial_sort(
+        candidates.begin(), candidates.begin() + count, candidates.end(),
+        [](const std::pair<double, ContentPane *> &a,
+           const std::pair<double, ContentPane *> &b) {
+            return a.first > b.first;
+        });
+    bool built = false;
+    for (std::size_t i = 0; i < count; i++) {
+        ContentPane *cpane = candidates.at(i).second;
+        if (!cpane->hasContentFactory()) {
+            continue;
+        }
+        if (built) {
+            // one content per idle event loop iteration
+            this->d->prefetchTimer.start();
+            return;
+        }
+        cpane->createContent();
+        built = true;
+    }
+}
+
+ContentPane *QAccordion::createContentPane(QString header, QFrame *content)
+{
+    return new ContentPane(std::move(header), content);
+}
+
 void QAccordion::numberOfPanesChanged(int number)
 {
+    this->schedulePrefetch();
+
     // automatically open contentpane if we have only one and collapsible is
     // false
-    if (number == 1 && !this->collapsible) {
-        this->contentPanes.at(0)->openContentPane();
+    if (number == 1 && !this->d->collapsible) {
+        this->setContentPaneActive(0, true);
     }
 }
 
-void QAccordion::paintEvent(ATTR_UNUSED QPaintEvent *event)
+bool QAccordion::event(QEvent *event)
+{
+    switch (event->type()) {
+    case QEvent::HoverEnter:
+    case QEvent::HoverMove:
+        this->updateHoveredHeader(static_cast<QHoverEvent *>(event)->pos());
+        // QWidget repaints the whole accordion on hover enter and leave, the
+        // headers take care of themselves
+        return true;
+    case QEvent::HoverLeave:
+        this->setHoveredHeader(nullptr);
+        return true;
+    default:
+        break;
+    }
+    return QWidget::event(event);
+}
+
+void QAccordion::moveEvent(QMoveEvent *event)
+{
+    QWidget::moveEvent(event);
+    this->updateStickyHeader();
+}
+
+void QAccordion::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    // the widget hierarchy is usually complete once the accordion is shown
+    this->trackScrollArea();
+    this->updateStickyHeader();
+}
+
+void QAccordion::resizeEvent(QResizeEvent *event)
+{
+    this->d->backgroundCache.update(this);
+    QWidget::resizeEvent(event);
+    this->updateStickyHeader();
+}
+
+void QAccordion::paintEvent(QPaintEvent *event)
 {
-    QStyleOption o;
-    o.initFrom(this);
-    QPainter p(this);
-    style()->drawPrimitive(QStyle::PE_Widget, &o, &p, this);
+    this->d->backgroundCache.paint(this, event);
+}
+
+void QAccordion::changeEvent(QEvent *event)
+{
+    if (this->d->stickyHeader != nullptr &&
+        (event->type() == QEvent::StyleChange ||
+         event->type() == QEvent::PaletteChange)) {
+        this->d->stickyHeader->invalidate();
+    }
+    if (event->type() == QEvent::ParentChange) {
+        this->trackScrollArea();
+        // the content panes may have a new outer pane or none
+        for (ContentPane *cpane : this->d->contentPanes) {
+            cpane->containerHeightChanged();
+        }
+    }
+    if (event->type() == QEvent::StyleChange ||
+        event->type() == QEvent::PaletteChange ||
+        event->type() == QEvent::EnabledChange) {
+        this->d->backgroundCache.invalidate();
+        this->d->backgroundCache.update(this);
+    }
+    QWidget::changeEvent(event);
 }
@@ -0,0 +1,111 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef QACCORDION_P_HPP
+#define QACCORDION_P_HPP
+
+#include <QAbstractScrollArea>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QPointer>
+#include <QString>
+#include <QTimer>
+#include <QVariantAnimation>
+
+#include <memory>
+#include <vector>
+
+#include "qaccordion/accordionlayout.hpp"
+#include "qaccordion/backgroundcache.hpp"
+#include "qaccordion/clickableframe.hpp"
+#include "qaccordion/contentpane.hpp"
+#include "qaccordion/heightcache.hpp"
+#include "qaccordion/qaccordion.hpp"
+#include "qaccordion/slotmap.hpp"
+#include "qaccordion/stickyheader.hpp"
+
+/*
+ * State of a QAccordion, kept out of qaccordion.hpp like ContentPanePrivate.
+ */
+struct QAccordionPrivate {
+    // layout of the accordion, owned by the widget
+    AccordionLayout *layout = nullptr;
+    std::vector<ContentPane *> contentPanes;
+    SlotMap<ContentPane *> paneSlots;
+
+    QString errorString;
+
+    // referenced by all headers
+    std::shared_ptr<const HeaderStyle> headerStyle;
+    // header under the mouse cursor, only this one has the hover style
+    QPointer<ClickableFrame> hoveredHeader;
+
+    BackgroundCache backgroundCache;
+
+    bool multiActive;
+    bool collapsible;
+
+    QAccordion::ANIMATION animationPolicy;
+    // number of running bulk operations, AUTO does not animate during them
+    int bulkOperations;
+    // average frame time of the last animations in milliseconds or -1
+    int frameTime;
+    // age of frameTime, the value decays so AUTO probes again
+    QElapsedTimer frameTimeAge;
+
+    // panes moved by the animation of setActive()
+    struct PaneTransition {
+        QPointer<ContentPane> cpane;
+        int from;
+        int to;
+    };
+    std::vector<PaneTransition> bulkTransition;
+    std::unique_ptr<QVariantAnimation> bulkAnimation;
+
+    // overlay for sticky headers, nullptr if disabled
+    StickyHeader *stickyHeader = nullptr;
+    // panes added after the overlay cover it
+    bool stickyHeaderLowered;
+    // closest enclosing scroll area and the connection to its scroll bar
+    QPointer<QAbstractScrollArea> scrollArea;
+    QMetaObject::Connection scrollConnection;
+
+    struct PaneUsage {
+        quint32 opens;
+        // milliseconds since epoch
+        qint64 lastOpened;
+    };
+    // usage by content pane key
+    QHash<QString, PaneUsage> paneUsage;
+    bool usageTracking;
+    uint prefetchCount;
+    // zero timer, fires when the event loop is idle
+    QTimer prefetchTimer;
+
+    HeightCache *heightCache = nullptr;
+
+    // content panes exist only while their section is expanded
+    struct Section {
+        QPointer<ContentPane> cpane;
+        std::vector<PaneSpec> panes;
+        std::vector<QPointer<ContentPane>> children;
+        bool expanded;
+    };
+    // sections by key
+    QHash<QString, Section> sections;
+};
+
+#endif  // QACCORDION_P_HPP
@@ -0,0 +1,41 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "qaccordion/qaccordiondelegate.hpp"
+
+QAccordionDelegate::QAccordionDelegate(QObject *parent) : QObject(parent) {}
+
+ContentPane *QAccordionDelegate::createContentPane(
+    const QModelIndex &index) const
+{
+    return new ContentPane(index.data(Qt::DisplayRole).toString());
+}
+
+QFrame *QAccordionDelegate::createContent(
+    ATTR_UNUSED const QModelIndex &index) const
+{
+    return nullptr;
+}
+
+void QAccordionDelegate::updateContentPane(ContentPane *cpane,
+                                           const QModelIndex &index) const
+{
+    cpane->setHeader(index.data(Qt::DisplayRole).toString());
+    QVariant tooltip = index.data(Qt::ToolTipRole);
+    if (tooltip.isValid()) {
+        cpane->setHeaderTooltip(tooltip.toString());
+    }
+}
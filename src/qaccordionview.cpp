@@ -0,0 +1,287 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "qaccordion/qaccordionview.hpp"
+
+#include <QPersistentModelIndex>
+
+QAccordionView::QAccordionView(QWidget *parent)
+    : QAccordion(parent), defaultDelegate(new QAccordionDelegate(this))
+{
+    this->modelColumn = 0;
+    this->delegate = this->defaultDelegate;
+}
+
+void QAccordionView::setModel(QAbstractItemModel *model)
+{
+    if (this->model == model) {
+        return;
+    }
+    if (!this->model.isNull()) {
+        QObject::disconnect(this->model, nullptr, this, nullptr);
+    }
+    this->model = model;
+
+    if (!this->model.isNull()) {
+        QObject::connect(this->model, &QAbstractItemModel::rowsInserted, this,
+                         &QAccordionView::modelRowsInserted);
+        QObject::connect(this->model, &QAbstractItemModel::rowsRemoved, this,
+                         &QAccordionView::modelRowsRemoved);
+        QObject::connect(this->model, &QAbstractItemModel::rowsMoved, this,
+                         &QAccordionView::modelRowsMoved);
+        QObject::connect(this->model, &QAbstractItemModel::dataChanged, this,
+                         &QAccordionView::modelDataChanged);
+        QObject::connect(this->model, &QAbstractItemModel::modelReset, this,
+                         &QAccordionView::modelReset);
+        QObject::connect(this->model,
+                         &QAbstractItemModel::layoutAboutToBeChanged, this,
+                         &QAccordionView::modelLayoutAboutToBeChanged);
+        QObject::connect(this->model, &QAbstractItemModel::layoutChanged, this,
+                         &QAccordionView::modelLayoutChanged);
+        QObject::connect(this->model, &QObject::destroyed, this,
+                         &QAccordionView::modelReset);
+    }
+
+    this->modelReset();
+}
+
+QAbstractItemModel *QAccordionView::getModel() const { return this->model; }
+
+void QAccordionView::setModelColumn(int column)
+{
+    if (this->modelColumn == column) {
+        return;
+    }
+    this->modelColumn = column;
+    this->modelReset();
+}
+
+int QAccordionView::getModelColumn() const { return this->modelColumn; }
+
+void QAccordionView::setDelegate(QAccordionDelegate *delegate)
+{
+    if (delegate == nullptr) {
+        delegate = this->defaultDelegate;
+    }
+    if (this->delegate == delegate) {
+        return;
+    }
+    this->delegate = delegate;
+    this->modelReset();
+}
+
+QAccordionDelegate *QAccordionView::getDelegate() const
+{
+    return this->delegate;
+}
+
+QModelIndex QAccordionView::getModelIndex(uint index) const
+{
+    if (this->model.isNull() ||
+        index >= static_cast<uint>(this->numberOfContentPanes())) {
+        return QModelIndex();
+    }
+    return this->model->index(static_cast<int>(index), this->modelColumn);
+}
+
+ContentPane *QAccordionView::createContentPaneForRow(int row)
+{
+    QAccordionDelegate *delegate = this->delegate;
+    if (delegate == nullptr) {
+        // the delegate set by the user has been deleted
+        delegate = this->defaultDelegate;
+        this->delegate = delegate;
+    }
+
+    QModelIndex index = this->model->index(row, this->modelColumn);
+    ContentPane *cpane = delegate->createContentPane(index);
+    delegate->updateContentPane(cpane, index);
+
+    // content is created when the pane is opened for the first time. the
+    // persistent index follows the row if it is moved in the meantime.
+    QPersistentModelIndex persistentIndex(index);
+    QPointer<QAccordionDelegate> contentDelegate(delegate);
+    cpane->setContentFactory([persistentIndex, contentDelegate]() -> QFrame * {
+        if (!persistentIndex.isValid() || contentDelegate.isNull()) {
+            return nullptr;
+        }
+        return contentDelegate->createContent(persistentIndex);
+    });
+    return cpane;
+}
+
+void QAccordionView::insertRows(int first, int last)
+{
+    std::vector<ContentPane *> panes;
+    panes.reserve(static_cast<std::size_t>(last - first + 1));
+    for (int row = first; row <= last; row++) {
+        panes.push_back(this->createContentPaneForRow(row));
+    }
+    this->insertContentPanes(static_cast<uint>(first), panes);
+}
+
+void QAccordionView::removeRows(int first, int last)
+{
+    this->removeContentPanes(true, static_cast<uint>(first),
+                             static_cast<uint>(last));
+}
+
+void QAccordionView::modelRowsInserted(const QModelIndex &parent, int first,
+                                       int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+    this->insertRows(first, last);
+}
+
+void QAccordionView::modelRowsRemoved(const QModelIndex &parent, int first,
+                                      int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+    this->removeRows(first, last);
+}
+
+void QAccordionView::modelRowsMoved(const QModelIndex &parent, int start,
+                                    int end, const QModelIndex &destination,
+                                    int row)
+{
+    int count = end - start + 1;
+    if (parent.isValid() && destination.isValid()) {
+        return;
+    }
+    // rows moved into or out of the top level are insertions and removals
+    if (parent.isValid()) {
+        this->insertRows(row, row + count - 1);
+        return;
+    }
+    if (destination.isValid()) {
+        this->removeRows(start, end);
+        return;
+    }
+
+    // row is the position before which the rows are moved, counted before
+    // the move. moveContentPanes wants the index of the first pane after it.
+    if (row > end) {
+        this->moveContentPanes(static_cast<uint>(start), static_cast<uint>(end),
+                               static_cast<uint>(row - count));
+    } else if (row < start) {
+        this->moveContentPanes(static_cast<uint>(start), static_cast<uint>(end),
+                               static_cast<uint>(row));
+    }
+}
+
+void QAccordionView::modelDataChanged(const QModelIndex &topLeft,
+                                      const QModelIndex &bottomRight,
+                                      ATTR_UNUSED const QVector<int> &roles)
+{
+    if (topLeft.parent().isValid() || this->model.isNull() ||
+        this->modelColumn < topLeft.column() ||
+        this->modelColumn > bottomRight.column()) {
+        return;
+    }
+    QAccordionDelegate *delegate =
+        this->delegate != nullptr ? this->delegate.data() : this->defaultDelegate;
+    for (int row = topLeft.row(); row <= bottomRight.row(); row++) {
+        ContentPane *cpane = this->getContentPane(static_cast<uint>(row));
+        if (cpane != nullptr) {
+            delegate->updateContentPane(
+                cpane, this->model->index(row, this->modelColumn));
+        }
+    }
+}
+
+void QAccordionView::modelLayoutAboutToBeChanged(
+    const QList<QPersistentModelIndex> &parents)
+{
+    this->layoutIndexes.clear();
+    // only the top level rows are of interest
+    if (this->model.isNull() ||
+        (!parents.isEmpty() && !parents.contains(QPersistentModelIndex()))) {
+        return;
+    }
+    int panes = this->numberOfContentPanes();
+    this->layoutIndexes.reserve(static_cast<std::size_t>(panes));
+    for (int row = 0; row < panes; row++) {
+        this->layoutIndexes.emplace_back(
+            this->model->index(row, this->modelColumn));
+    }
+}
+
+void QAccordionView::modelLayoutChanged(
+    const QList<QPersistentModelIndex> &parents)
+{
+    if (!parents.isEmpty() && !parents.contains(QPersistentModelIndex())) {
+        return;
+    }
+    std::vector<QPersistentModelIndex> indexes;
+    indexes.swap(this->layoutIndexes);
+    if (this->model.isNull() ||
+        static_cast<int>(indexes.size()) != this->numberOfContentPanes()) {
+        // no layoutAboutToBeChanged() for our rows, we can not map them
+        this->modelReset();
+        return;
+    }
+
+    // rows that left the top level are removed. from the back so every
+    // contiguous range is reported once.
+    int rangeLast = -1;
+    for (int i = static_cast<int>(indexes.size()) - 1; i >= -1; i--) {
+        if (i >= 0 &&
+            (!indexes.at(i).isValid() || indexes.at(i).parent().isValid())) {
+            if (rangeLast == -1) {
+                rangeLast = i;
+            }
+            continue;
+        }
+        if (rangeLast != -1) {
+            this->removeRows(i + 1, rangeLast);
+            indexes.erase(indexes.begin() + i + 1,
+                          indexes.begin() + rangeLast + 1);
+            rangeLast = -1;
+        }
+    }
+    if (static_cast<int>(indexes.size()) != this->model->rowCount()) {
+        // rows appeared without rowsInserted()
+        this->modelReset();
+        return;
+    }
+
+    // the remaining panes follow their rows
+    std::vector<int> targets;
+    targets.reserve(indexes.size());
+    for (const QPersistentModelIndex &index : indexes) {
+        targets.push_back(index.row());
+    }
+    this->reorderContentPanes(targets);
+}
+
+void QAccordionView::modelReset()
+{
+    int panes = this->numberOfContentPanes();
+    if (panes > 0) {
+        this->removeRows(0, panes - 1);
+    }
+    if (this->model.isNull()) {
+        return;
+    }
+    int rows = this->model->rowCount();
+    if (rows > 0) {
+        this->insertRows(0, rows - 1);
+    }
+}
@@ -0,0 +1,110 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "qaccordion/stickyheader.hpp"
+
+#include <QCoreApplication>
+#include <QPainter>
+
+#include "qaccordion/accordiontrace.hpp"
+
+StickyHeader::StickyHeader(QWidget *parent) : QWidget(parent)
+{
+    // transparent parts of the header must not show the panes below
+    this->setAutoFillBackground(true);
+    this->setBackgroundRole(QPalette::Window);
+}
+
+void StickyHeader::setHeader(ClickableFrame *header)
+{
+    if (this->header != header) {
+        if (!this->header.isNull()) {
+            QObject::disconnect(this->header, nullptr, this, nullptr);
+        }
+        this->header = header;
+        this->pixmap = QPixmap();
+        // icon, text, hover and style changes
+        QObject::connect(header, &ClickableFrame::appearanceChanged, this,
+                         &StickyHeader::headerChanged);
+    }
+    if (!this->pixmap.isNull() &&
+        this->pixmap.size() ==
+            header->size() * this->pixmap.devicePixelRatio()) {
+        return;
+    }
+    this->grabHeader();
+}
+
+ClickableFrame *StickyHeader::getHeader() const { return this->header; }
+
+void StickyHeader::invalidate()
+{
+    this->pixmap = QPixmap();
+}
+
+void StickyHeader::headerChanged()
+{
+    // a hidden overlay grabs on the next setHeader()
+    if (this->isVisible()) {
+        this->grabHeader();
+    } else {
+        this->invalidate();
+    }
+}
+
+void StickyHeader::grabHeader()
+{
+    QACCORDION_TRACE_SCOPE("StickyHeader::grab");
+    this->pixmap = this->header->grab();
+    this->setCursor(this->header->cursor());
+    this->update();
+}
+
+void StickyHeader::paintEvent(QPaintEvent *event)
+{
+    QPainter p(this);
+    p.setClipRegion(event->region());
+    p.drawPixmap(0, 0, this->pixmap);
+}
+
+void StickyHeader::mousePressEvent(QMouseEvent *event)
+{
+    this->forwardEvent(event);
+}
+
+void StickyHeader::mouseReleaseEvent(QMouseEvent *event)
+{
+    this->forwardEvent(event);
+}
+
+void StickyHeader::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    this->forwardEvent(event);
+}
+
+void StickyHeader::forwardEvent(QMouseEvent *event)
+{
+    if (this->header.isNull()) {
+        event->ignore();
+        return;
+    }
+    // the overlay has the size of the header, local positions are the same
+    QMouseEvent forwarded(event->type(), event->localPos(), event->windowPos(),
+                          event->screenPos(), event->button(), event->buttons(),
+                          event->modifiers());
+    QCoreApplication::sendEvent(this->header, &forwarded);
+    event->setAccepted(forwarded.isAccepted());
+}
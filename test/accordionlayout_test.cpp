@@ -0,0 +1,100 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "qaccordion/accordionlayout.hpp"
+
+#include <QApplication>
+
+#include <cstdio>
+
+#include "qaccordion/animationclock.hpp"
+#include "qaccordion/qaccordion.hpp"
+
+#define CHECK(condition)                                                       \
+    do {                                                                       \
+        if (!(condition)) {                                                    \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__,       \
+                         __LINE__, #condition);                                \
+            return 1;                                                          \
+        }                                                                      \
+    } while (false)
+
+static const int PANES = 200;
+
+// nested layouts post their LayoutRequests one level per iteration
+static void settle()
+{
+    for (int i = 0; i < 5; i++) {
+        QApplication::processEvents();
+    }
+}
+
+static int testAnimationFrame()
+{
+    AnimationClock clock;
+    clock.install();
+    QAccordion accordion;
+    for (int i = 0; i < PANES; i++) {
+        accordion.addContentPane("Content Pane " + QString::number(i));
+    }
+    accordion.resize(400, 600);
+    accordion.show();
+    settle();
+    auto *layout = qobject_cast<AccordionLayout *>(accordion.layout());
+    CHECK(layout != nullptr);
+
+    // the new header icon is an invalidation of unknown origin
+    accordion.getContentPane(PANES / 2)->headerTriggered(QPoint());
+    settle();
+
+    // every frame of the open animation only measures the opening pane
+    for (int frame = 0; frame < 5; frame++) {
+        int height = layout->itemHeight(PANES / 2);
+        clock.step(16);
+        settle();
+        CHECK(layout->itemHeight(PANES / 2) > height);
+        CHECK(layout->getUpdatedItems() == 1);
+    }
+    return 0;
+}
+
+static int testUnknownInvalidation()
+{
+    QAccordion accordion;
+    for (int i = 0; i < PANES; i++) {
+        accordion.addContentPane("Content Pane " + QString::number(i));
+    }
+    accordion.resize(400, 600);
+    accordion.show();
+    settle();
+    auto *layout = qobject_cast<AccordionLayout *>(accordion.layout());
+    CHECK(layout != nullptr);
+
+    layout->setSpacing(layout->spacing() + 1);
+    settle();
+    CHECK(layout->getUpdatedItems() == PANES);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    // no window is shown, do not depend on a display
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    return testAnimationFrame() || testUnknownInvalidation();
+}
@@ -0,0 +1,151 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "qaccordion/fenwicktree.hpp"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#define CHECK(condition)                                                       \
+    do {                                                                       \
+        if (!(condition)) {                                                    \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__,       \
+                         __LINE__, #condition);                                \
+            return 1;                                                          \
+        }                                                                      \
+    } while (false)
+
+// compare all prefix sums and find() with a plain vector
+static bool matches(const FenwickTree<int> &tree, const std::vector<int> &values)
+{
+    if (tree.size() != values.size()) {
+        return false;
+    }
+    int sum = 0;
+    for (std::size_t i = 0; i <= values.size(); i++) {
+        if (tree.prefixSum(i) != sum) {
+            return false;
+        }
+        if (i < values.size()) {
+            if (tree.value(i) != values.at(i)) {
+                return false;
+            }
+            if (values.at(i) > 0 && tree.find(sum) != i) {
+                return false;
+            }
+            sum += values.at(i);
+        }
+    }
+    return tree.total() == sum && tree.find(sum) == values.size();
+}
+
+static int testAssign()
+{
+    FenwickTree<int> tree;
+    CHECK(tree.size() == 0);
+    CHECK(tree.total() == 0);
+    CHECK(tree.find(0) == 0);
+    std::vector<int> values = {3, 0, 5, 1, 7, 2, 0, 4, 6};
+    tree.assign(values);
+    CHECK(matches(tree, values));
+    tree.clear();
+    CHECK(matches(tree, {}));
+    return 0;
+}
+
+static int testSet()
+{
+    FenwickTree<int> tree;
+    std::vector<int> values(37, 2);
+    tree.assign(values);
+    values.at(0) = 10;
+    tree.set(0, 10);
+    values.at(36) = 0;
+    tree.set(36, 0);
+    values.at(17) = 9;
+    tree.set(17, 9);
+    CHECK(matches(tree, values));
+    return 0;
+}
+
+static int testInsertErase()
+{
+    FenwickTree<int> tree;
+    std::vector<int> values;
+    // appending
+    for (int i = 0; i < 100; i++) {
+        tree.insert(tree.size(), i % 7);
+        values.push_back(i % 7);
+    }
+    CHECK(matches(tree, values));
+    // in front and in the middle
+    tree.insert(0, 5);
+    values.insert(values.begin(), 5);
+    tree.insert(50, 3, 4);
+    values.insert(values.begin() + 50, 3, 4);
+    CHECK(matches(tree, values));
+    tree.erase(10, 20);
+    values.erase(values.begin() + 10, values.begin() + 30);
+    tree.erase(tree.size() - 1);
+    values.pop_back();
+    tree.erase(0);
+    values.erase(values.begin());
+    CHECK(matches(tree, values));
+    return 0;
+}
+
+static int testRandom()
+{
+    std::mt19937 random(42);
+    FenwickTree<int> tree;
+    std::vector<int> values;
+    for (int step = 0; step < 5000; step++) {
+        std::size_t index = random() % (values.size() + 1);
+        switch (random() % 3) {
+        case 0: {
+            std::size_t count = random() % 4;
+            int value = static_cast<int>(random() % 50);
+            tree.insert(index, count, value);
+            values.insert(values.begin() + index, count, value);
+            break;
+        }
+        case 1:
+            if (index < values.size()) {
+                std::size_t count = std::min<std::size_t>(
+                    random() % 3 + 1, values.size() - index);
+                tree.erase(index, count);
+                values.erase(values.begin() + index,
+                             values.begin() + index + count);
+            }
+            break;
+        default:
+            if (index < values.size()) {
+                int value = static_cast<int>(random() % 50);
+                tree.set(index, value);
+                values.at(index) = value;
+            }
+            break;
+        }
+        CHECK(matches(tree, values));
+    }
+    return 0;
+}
+
+int main()
+{
+    return testAssign() || testSet() || testInsertErase() || testRandom();
+}
@@ -0,0 +1,108 @@
+// This file is part of qAccordion. An Accordion widget for Qt
+// Copyright © 2015, 2017, 2020 Christian Rapp <0x2a at posteo dot org>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "qaccordion/slotmap.hpp"
+
+#include <cstdio>
+#include <vector>
+
+#define CHECK(condition)                                                       \
+    do {                                                                       \
+        if (!(condition)) {                                                    \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__,       \
+                         __LINE__, #condition);                                \
+            return 1;                                                          \
+        }                                                                      \
+    } while (false)
+
+static int testInsertGet()
+{
+    SlotMap<int> map;
+    SlotHandle a = map.insert(1);
+    SlotHandle b = map.insert(2);
+    CHECK(!a.isNull());
+    CHECK(a != b);
+    CHECK(map.size() == 2);
+    CHECK(map.get(a) != nullptr && *map.get(a) == 1);
+    CHECK(map.get(b) != nullptr && *map.get(b) == 2);
+    *map.get(a) = 3;
+    CHECK(*map.get(a) == 3);
+    return 0;
+}
+
+static int testNullHandle()
+{
+    SlotMap<int> map;
+    map.insert(1);
+    SlotHandle null;
+    CHECK(null.isNull());
+    CHECK(!map.contains(null));
+    CHECK(map.get(null) == nullptr);
+    CHECK(!map.erase(null));
+    return 0;
+}
+
+static int testStaleHandle()
+{
+    SlotMap<int> map;
+    SlotHandle a = map.insert(1);
+    CHECK(map.erase(a));
+    CHECK(!map.erase(a));
+    CHECK(!map.contains(a));
+    CHECK(map.get(a) == nullptr);
+    CHECK(map.size() == 0);
+
+    // the slot is reused, the old handle must not resolve to the new element
+    SlotHandle b = map.insert(2);
+    CHECK(b.index == a.index);
+    CHECK(b != a);
+    CHECK(map.get(a) == nullptr);
+    CHECK(*map.get(b) == 2);
+    CHECK(map.capacity() == 1);
+    return 0;
+}
+
+static int testManyElements()
+{
+    SlotMap<int> map;
+    std::vector<SlotHandle> handles;
+    for (int i = 0; i < 1000; i++) {
+        handles.push_back(map.insert(i));
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        CHECK(map.erase(handles.at(i)));
+    }
+    CHECK(map.size() == 500);
+    for (int i = 0; i < 1000; i++) {
+        CHECK(map.contains(handles.at(i)) == (i % 2 == 1));
+        if (i % 2 == 1) {
+            CHECK(*map.get(handles.at(i)) == i);
+        }
+    }
+    for (int i = 0; i < 500; i++) {
+        map.insert(i);
+    }
+    // free slots are reused before new ones are allocated
+    CHECK(map.capacity() == 1000);
+    CHECK(map.size() == 1000);
+    return 0;
+}
+
+int main()
+{
+    return testInsertGet() || testNullHandle() || testStaleHandle() ||
+           testManyElements();
+}